@@ -0,0 +1,82 @@
+#include "moar.h"
+
+/* Deserialization is normally lazy: an STable or object is only finished
+ * when something touches it, on the thread that touched it. With
+ * MVM_DESERIALIZE_THREADS set, a pool of helper threads instead takes each
+ * serialization context as soon as it is loaded and demands everything in
+ * it, so the main thread mostly finds the work already done. The helpers go
+ * through the same demand functions as lazy deserialization, so they and any
+ * other thread synchronize on the SC's mutex and its reader's working count.
+ * Since SCs only depend on SCs loaded before them, two threads working on
+ * different SCs can never each hold the mutex the other one wants. */
+
+/* Enters the work loop. */
+static void worker(MVMThreadContext *tc, MVMCallsite *callsite, MVMRegister *args) {
+#ifdef MVM_HAS_PTHREAD_SETNAME_NP
+    pthread_setname_np(pthread_self(), "deserializer");
+#endif
+
+    while (1) {
+        MVMSerializationContext *sc = (MVMSerializationContext *)MVM_repr_shift_o(tc,
+            tc->instance->deserialize_queue);
+        if (MVM_is_null(tc, (MVMObject *)sc))
+            break;
+        MVMROOT(tc, sc, {
+            MVMint64 i;
+            for (i = 0; sc->body->sr && i < sc->body->sr->root.num_stables; i++)
+                MVM_serialization_demand_stable(tc, sc, i);
+            for (i = 0; sc->body->sr && i < sc->body->sr->root.num_objects; i++)
+                MVM_serialization_demand_object(tc, sc, i);
+        });
+    }
+}
+
+/* Starts the helper threads, if any are wanted. Not thread safe per
+ * instance, but only used while the instance is still single-threaded. */
+void MVM_deserialize_worker_start(MVMThreadContext *tc) {
+    MVMuint32 i;
+    if (tc->instance->num_deserialize_threads) {
+        assert(tc->instance->deserialize_threads == NULL);
+
+        /* If we restart the helpers, do not reinitialize the queue */
+        if (!tc->instance->deserialize_queue)
+            tc->instance->deserialize_queue = MVM_repr_alloc_init(tc,
+                tc->instance->boot_types.BOOTQueue);
+        tc->instance->deserialize_threads = MVM_repr_alloc_init(tc,
+            tc->instance->boot_types.BOOTArray);
+
+        for (i = 0; i < tc->instance->num_deserialize_threads; i++) {
+            MVMObject *worker_entry_point = MVM_repr_alloc_init(tc,
+                tc->instance->boot_types.BOOTCCode);
+            MVMObject *thread;
+            ((MVMCFunction *)worker_entry_point)->body.func = worker;
+            thread = MVM_thread_new(tc, worker_entry_point, 1);
+            MVM_repr_push_o(tc, tc->instance->deserialize_threads, thread);
+            MVM_thread_run(tc, thread);
+        }
+    }
+}
+
+/* Sends each helper thread a stop sentinel. */
+void MVM_deserialize_worker_stop(MVMThreadContext *tc) {
+    MVMuint32 i;
+    if (tc->instance->deserialize_threads)
+        for (i = 0; i < tc->instance->num_deserialize_threads; i++)
+            MVM_repr_unshift_o(tc, tc->instance->deserialize_queue, tc->instance->VMNull);
+}
+
+/* Waits for the helper threads to finish. */
+void MVM_deserialize_worker_join(MVMThreadContext *tc) {
+    MVMuint32 i;
+    if (tc->instance->deserialize_threads) {
+        for (i = 0; i < tc->instance->num_deserialize_threads; i++)
+            MVM_thread_join(tc, MVM_repr_at_pos_o(tc, tc->instance->deserialize_threads, i));
+        tc->instance->deserialize_threads = NULL;
+    }
+}
+
+/* Hands a freshly loaded SC to the helper threads, if there are any. */
+void MVM_deserialize_worker_enqueue(MVMThreadContext *tc, MVMSerializationContext *sc) {
+    if (tc->instance->deserialize_threads)
+        MVM_repr_push_o(tc, tc->instance->deserialize_queue, (MVMObject *)sc);
+}
@@ -0,0 +1,4 @@
+void MVM_deserialize_worker_start(MVMThreadContext *tc);
+void MVM_deserialize_worker_stop(MVMThreadContext *tc);
+void MVM_deserialize_worker_join(MVMThreadContext *tc);
+void MVM_deserialize_worker_enqueue(MVMThreadContext *tc, MVMSerializationContext *sc);
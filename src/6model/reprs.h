@@ -45,6 +45,7 @@
 #include "6model/reprs/MVMSpeshLog.h"
 #include "6model/reprs/MVMStaticFrameSpesh.h"
 #include "6model/reprs/MVMSpeshPluginState.h"
+#include "6model/reprs/BytecodeWriter.h"
 
 /* REPR related functions. */
 void MVM_repr_initialize_registry(MVMThreadContext *tc);
@@ -100,8 +101,9 @@ const MVMREPROps * MVM_repr_get_by_name(MVMThreadContext *tc, MVMString *name);
 #define MVM_REPR_ID_Decoder                 43
 #define MVM_REPR_ID_MVMStaticFrameSpesh     44
 #define MVM_REPR_ID_MVMSpeshPluginState     45
+#define MVM_REPR_ID_BytecodeWriter          46
 
-#define MVM_REPR_CORE_COUNT                 46
+#define MVM_REPR_CORE_COUNT                 47
 #define MVM_REPR_MAX_COUNT                  64
 
 /* Default attribute functions for a REPR that lacks them. */
@@ -0,0 +1,845 @@
+#include "moar.h"
+
+/* The bytecode version written, and the sizes of its fixed parts; see
+ * src/core/bytecode.c for the reading side. */
+#define BYTECODE_VERSION    8
+#define HEADER_SIZE         96
+#define FRAME_HEADER_SIZE   54
+#define EXTOP_RECORD_SIZE   12
+
+/* The longest string that fits in a string heap entry, whose size is
+ * stored shifted left by two bits, with the encoding below it. */
+#define MAX_STRING_BYTES    ((MVMuint64)1 << 30)
+
+/* This representation's function pointer table. */
+static const MVMREPROps BytecodeWriter_this_repr;
+
+/* Creates a new type object of this representation, and associates it with
+ * the given HOW. */
+static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
+    MVMSTable *st  = MVM_gc_allocate_stable(tc, &BytecodeWriter_this_repr, HOW);
+
+    MVMROOT(tc, st, {
+        MVMObject *obj = MVM_gc_allocate_type_object(tc, st);
+        MVM_ASSIGN_REF(tc, &(st->header), st->WHAT, obj);
+        st->size = sizeof(MVMBytecodeWriter);
+    });
+
+    return st->WHAT;
+}
+
+/* Copies the body of one object to another. */
+static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *dest_root, void *dest) {
+    MVM_exception_throw_adhoc(tc, "Cannot copy object with representation BytecodeWriter");
+}
+
+/* Called by the VM to mark any GCable items. */
+static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
+    MVMBytecodeWriterBody *body = (MVMBytecodeWriterBody *)data;
+    MVM_gc_worklist_add(tc, worklist, &(body->strings));
+    MVM_gc_worklist_add(tc, worklist, &(body->string_indexes));
+}
+
+/* Called by the VM in order to free memory associated with this object. */
+static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
+    MVMBytecodeWriter *writer = (MVMBytecodeWriter *)obj;
+    MVM_VECTOR_DESTROY(writer->body.frames.data);
+    MVM_VECTOR_DESTROY(writer->body.bytecode.data);
+    MVM_VECTOR_DESTROY(writer->body.annotations.data);
+    MVM_VECTOR_DESTROY(writer->body.callsites.data);
+    MVM_VECTOR_DESTROY(writer->body.callsite_offsets);
+    MVM_VECTOR_DESTROY(writer->body.extops.data);
+    MVM_VECTOR_DESTROY(writer->body.labels);
+    MVM_VECTOR_DESTROY(writer->body.label_fixups);
+    MVM_free(writer->body.callsite_table);
+}
+
+static const MVMStorageSpec storage_spec = {
+    MVM_STORAGE_SPEC_REFERENCE, /* inlineable */
+    0,                          /* bits */
+    0,                          /* align */
+    MVM_STORAGE_SPEC_BP_NONE,   /* boxed_primitive */
+    0,                          /* can_box */
+    0,                          /* is_unsigned */
+};
+
+
+/* Gets the storage specification for this representation. */
+static const MVMStorageSpec * get_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
+    return &storage_spec;
+}
+
+/* Compose the representation. */
+static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info) {
+    /* Nothing to do for this REPR. */
+}
+
+/* Set the size of the STable. */
+static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSerializationReader *reader) {
+    st->size = sizeof(MVMBytecodeWriter);
+}
+
+/* Calculates the non-GC-managed memory we hold on to. */
+static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
+    MVMBytecodeWriterBody *body = (MVMBytecodeWriterBody *)data;
+    return MVM_VECTOR_SIZE(body->frames.data) + MVM_VECTOR_SIZE(body->bytecode.data)
+        + MVM_VECTOR_SIZE(body->annotations.data) + MVM_VECTOR_SIZE(body->callsites.data)
+        + MVM_VECTOR_SIZE(body->callsite_offsets) + MVM_VECTOR_SIZE(body->extops.data)
+        + body->callsite_table_size * sizeof(MVMuint32);
+}
+
+/* Initializes the representation. */
+const MVMREPROps * MVMBytecodeWriter_initialize(MVMThreadContext *tc) {
+    return &BytecodeWriter_this_repr;
+}
+
+static const MVMREPROps BytecodeWriter_this_repr = {
+    type_object_for,
+    MVM_gc_allocate_object,
+    NULL, /* initialize */
+    copy_to,
+    MVM_REPR_DEFAULT_ATTR_FUNCS,
+    MVM_REPR_DEFAULT_BOX_FUNCS,
+    MVM_REPR_DEFAULT_POS_FUNCS,
+    MVM_REPR_DEFAULT_ASS_FUNCS,
+    MVM_REPR_DEFAULT_ELEMS,
+    get_storage_spec,
+    NULL, /* change_type */
+    NULL, /* serialize */
+    NULL, /* deserialize */
+    NULL, /* serialize_repr_data */
+    NULL, /* deserialize_repr_data */
+    deserialize_stable_size,
+    gc_mark,
+    gc_free,
+    NULL, /* gc_cleanup */
+    NULL, /* gc_mark_repr_data */
+    NULL, /* gc_free_repr_data */
+    compose,
+    NULL, /* spesh */
+    "BytecodeWriter", /* name */
+    MVM_REPR_ID_BytecodeWriter,
+    unmanaged_size,
+    NULL, /* describe_refs */
+};
+
+/* Assert that the passed object really is a bytecode writer; throw if not. */
+void MVM_bytecode_writer_ensure_writer(MVMThreadContext *tc, MVMObject *writer, const char *op) {
+    if (MVM_UNLIKELY(REPR(writer)->ID != MVM_REPR_ID_BytecodeWriter || !IS_CONCRETE(writer)))
+        MVM_exception_throw_adhoc(tc,
+            "Operation '%s' can only work on an object with the BytecodeWriter representation",
+            op);
+}
+
+/* Appends to a buffer; everything is written little endian, as the reader
+ * expects. */
+static void write_u8(MVMBytecodeWriterBuffer *buf, MVMuint8 value) {
+    MVM_VECTOR_PUSH(buf->data, value);
+}
+static void write_u16(MVMBytecodeWriterBuffer *buf, MVMuint16 value) {
+    write_u8(buf, (MVMuint8)(value & 0xFF));
+    write_u8(buf, (MVMuint8)(value >> 8));
+}
+static void write_u32(MVMBytecodeWriterBuffer *buf, MVMuint32 value) {
+    write_u16(buf, (MVMuint16)(value & 0xFFFF));
+    write_u16(buf, (MVMuint16)(value >> 16));
+}
+static void write_u64(MVMBytecodeWriterBuffer *buf, MVMuint64 value) {
+    write_u32(buf, (MVMuint32)(value & 0xFFFFFFFF));
+    write_u32(buf, (MVMuint32)(value >> 32));
+}
+static void write_bytes(MVMBytecodeWriterBuffer *buf, const void *data, size_t size) {
+    if (size)
+        MVM_VECTOR_APPEND(buf->data, (const MVMuint8 *)data, size);
+}
+static void write_zeroes(MVMBytecodeWriterBuffer *buf, size_t size) {
+    while (size--)
+        write_u8(buf, 0);
+}
+static void patch_u16(MVMBytecodeWriterBuffer *buf, size_t pos, MVMuint16 value) {
+    buf->data[pos]     = (MVMuint8)(value & 0xFF);
+    buf->data[pos + 1] = (MVMuint8)(value >> 8);
+}
+static void patch_u32(MVMBytecodeWriterBuffer *buf, size_t pos, MVMuint32 value) {
+    patch_u16(buf, pos, (MVMuint16)(value & 0xFFFF));
+    patch_u16(buf, pos + 2, (MVMuint16)(value >> 16));
+}
+
+/* Steps through the values of a native int array passed to the writer,
+ * throwing if they run out or one is out of range. */
+typedef struct {
+    MVMint64   *values;
+    MVMuint64   elems;
+    MVMuint64   pos;
+    const char *what;
+} ValueReader;
+
+static void init_reader(MVMThreadContext *tc, ValueReader *vr, MVMObject *array, const char *what) {
+    MVMArrayREPRData *repr_data;
+    if (!IS_CONCRETE(array) || REPR(array)->ID != MVM_REPR_ID_VMArray
+            || !(repr_data = (MVMArrayREPRData *)STABLE(array)->REPR_data)
+            || repr_data->slot_type != MVM_ARRAY_I64)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer %s must be a native int array", what);
+    vr->values = ((MVMArray *)array)->body.slots.i64 + ((MVMArray *)array)->body.start;
+    vr->elems  = ((MVMArray *)array)->body.elems;
+    vr->pos    = 0;
+    vr->what   = what;
+}
+static MVMint64 next_value(MVMThreadContext *tc, ValueReader *vr) {
+    if (vr->pos >= vr->elems)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer %s ends prematurely", vr->what);
+    return vr->values[vr->pos++];
+}
+static MVMuint32 next_in_range(MVMThreadContext *tc, ValueReader *vr, MVMuint64 limit, const char *name) {
+    MVMint64 value = next_value(tc, vr);
+    if (value < 0 || (MVMuint64)value >= limit)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer %s has %s %"PRId64" out of range",
+            vr->what, name, value);
+    return (MVMuint32)value;
+}
+static MVMuint32 next_string(MVMThreadContext *tc, MVMBytecodeWriterBody *body, ValueReader *vr) {
+    return next_in_range(tc, vr, body->num_indexed, "string index");
+}
+
+/* Brings the string index up to date with the heap, which the serializer
+ * may have added strings to. It also unshifts a NULL onto the heap, which
+ * is not part of the bytecode string heap, so is shifted off again. */
+static void sync_strings(MVMThreadContext *tc, MVMBytecodeWriter *writer) {
+    MVMint64 elems;
+    MVMROOT(tc, writer, {
+        if (!writer->body.strings) {
+            MVMObject *strings = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTStrArray);
+            MVMObject *indexes;
+            MVM_ASSIGN_REF(tc, &(writer->common.header), writer->body.strings, strings);
+            indexes = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTHash);
+            MVM_ASSIGN_REF(tc, &(writer->common.header), writer->body.string_indexes, indexes);
+        }
+        elems = MVM_repr_elems(tc, writer->body.strings);
+        if (elems > writer->body.num_indexed && !MVM_repr_at_pos_s(tc, writer->body.strings, 0)) {
+            MVM_repr_shift_s(tc, writer->body.strings);
+            elems--;
+        }
+        while (writer->body.num_indexed < elems) {
+            MVMString *str = MVM_repr_at_pos_s(tc, writer->body.strings, writer->body.num_indexed);
+            MVMROOT(tc, str, {
+                MVM_repr_bind_key_int(tc, writer->body.string_indexes, str, writer->body.num_indexed);
+            });
+            writer->body.num_indexed++;
+        }
+    });
+}
+
+/* Adds a string to the string heap if it is not there already, and returns
+ * its index. */
+MVMint64 MVM_bytecode_writer_string(MVMThreadContext *tc, MVMBytecodeWriter *writer, MVMString *str) {
+    MVMint64 index;
+    MVM_string_check_arg(tc, str, "bytecode writer string");
+    MVMROOT2(tc, writer, str, {
+        sync_strings(tc, writer);
+        if (MVM_repr_exists_key(tc, writer->body.string_indexes, str)) {
+            index = MVM_repr_at_key_int(tc, writer->body.string_indexes, str);
+        }
+        else {
+            index = writer->body.num_indexed;
+            MVM_repr_push_s(tc, writer->body.strings, str);
+            MVM_repr_bind_key_int(tc, writer->body.string_indexes, str, index);
+            writer->body.num_indexed++;
+        }
+    });
+    return index;
+}
+
+/* Gets the string heap, to pass to the serializer so the serialized data
+ * refers to the same heap. */
+MVMObject * MVM_bytecode_writer_strings(MVMThreadContext *tc, MVMBytecodeWriter *writer) {
+    sync_strings(tc, writer);
+    return writer->body.strings;
+}
+
+/* Hash of a callsite record, for the callsite table. */
+static MVMuint32 hash_bytes(const MVMuint8 *data, size_t size) {
+    MVMuint32 hash = 2166136261u;
+    size_t i;
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Size of a callsite record; records_end is where the last one ends. */
+static size_t callsite_size(MVMBytecodeWriterBody *body, MVMuint32 idx, size_t records_end) {
+    size_t end = idx + 1 < body->callsite_offsets_num
+        ? body->callsite_offsets[idx + 1]
+        : records_end;
+    return end - body->callsite_offsets[idx];
+}
+
+/* Finds the slot of the callsite table that holds a callsite with the given
+ * record, or the empty one where it would go. */
+static MVMuint32 * callsite_slot(MVMBytecodeWriterBody *body, const MVMuint8 *record, size_t size,
+                                 size_t records_end) {
+    MVMuint32 mask = body->callsite_table_size - 1;
+    MVMuint32 slot = hash_bytes(record, size) & mask;
+    while (body->callsite_table[slot]) {
+        MVMuint32 idx = body->callsite_table[slot] - 1;
+        if (callsite_size(body, idx, records_end) == size
+                && memcmp(body->callsites.data + body->callsite_offsets[idx], record, size) == 0)
+            break;
+        slot = (slot + 1) & mask;
+    }
+    return &(body->callsite_table[slot]);
+}
+
+static void grow_callsite_table(MVMBytecodeWriterBody *body) {
+    MVMuint32 i;
+    MVM_free(body->callsite_table);
+    body->callsite_table_size = body->callsite_table_size ? body->callsite_table_size * 2 : 64;
+    body->callsite_table      = MVM_calloc(body->callsite_table_size, sizeof(MVMuint32));
+    for (i = 0; i < body->callsite_offsets_num; i++)
+        *callsite_slot(body, body->callsites.data + body->callsite_offsets[i],
+            callsite_size(body, i, body->callsites.data_num), body->callsites.data_num) = i + 1;
+}
+
+/* Adds a callsite with the given argument flags and names of the named
+ * arguments, returning its index. Identical callsites share an index. */
+MVMint64 MVM_bytecode_writer_callsite(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                      MVMObject *flags, MVMObject *names) {
+    MVMBytecodeWriterBody *body;
+    ValueReader  fr;
+    MVMuint64    num_names = 0, i;
+    MVMuint32    num_nameds = 0, *slot;
+    size_t       start;
+
+    /* Check the flags, and that there is a name for each named argument. */
+    init_reader(tc, &fr, flags, "callsite flags");
+    if (fr.elems > 0xFFFF)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer callsite has too many arguments");
+    for (i = 0; i < fr.elems; i++) {
+        MVMuint32 flag = next_in_range(tc, &fr, 256, "flag");
+        if ((flag & MVM_CALLSITE_ARG_NAMED)
+                && !(flag & (MVM_CALLSITE_ARG_FLAT | MVM_CALLSITE_ARG_FLAT_NAMED)))
+            num_nameds++;
+    }
+    if (!MVM_is_null(tc, names) && IS_CONCRETE(names))
+        num_names = MVM_repr_elems(tc, names);
+    if (num_names != num_nameds)
+        MVM_exception_throw_adhoc(tc,
+            "Bytecode writer callsite has %"PRIu64" names for %u named arguments",
+            num_names, num_nameds);
+
+    /* Put the names in the string heap before writing anything. */
+    MVMROOT3(tc, writer, flags, names, {
+        for (i = 0; i < num_names; i++)
+            MVM_bytecode_writer_string(tc, writer, MVM_repr_at_pos_s(tc, names, i));
+    });
+
+    /* Write the record after the others, and look for an identical one. */
+    body  = &writer->body;
+    if ((body->callsite_offsets_num + 1) * 2 > body->callsite_table_size)
+        grow_callsite_table(body);
+    start = body->callsites.data_num;
+    init_reader(tc, &fr, flags, "callsite flags");
+    write_u16(&body->callsites, (MVMuint16)fr.elems);
+    for (i = 0; i < fr.elems; i++)
+        write_u8(&body->callsites, (MVMuint8)fr.values[i]);
+    if (fr.elems % 2)
+        write_u8(&body->callsites, 0);
+    for (i = 0; i < num_names; i++)
+        write_u32(&body->callsites, (MVMuint32)MVM_repr_at_key_int(tc, body->string_indexes,
+            MVM_repr_at_pos_s(tc, names, i)));
+    slot = callsite_slot(body, body->callsites.data + start, body->callsites.data_num - start, start);
+    if (*slot) {
+        body->callsites.data_num = start;
+        return *slot - 1;
+    }
+    MVM_VECTOR_PUSH(body->callsite_offsets, (MVMuint32)start);
+    *slot = (MVMuint32)body->callsite_offsets_num;
+    return *slot - 1;
+}
+
+/* Gets the slot of a label, by its ID within the frame. There cannot be
+ * more labels than values in the frame's instruction stream. */
+static MVMuint32 * label_slot(MVMThreadContext *tc, MVMBytecodeWriterBody *body, ValueReader *vr,
+                              MVMuint64 max_labels) {
+    MVMuint32 label = next_in_range(tc, vr, max_labels, "label");
+    if (label >= body->labels_num) {
+        MVM_VECTOR_ENSURE_SIZE(body->labels, label);
+        body->labels_num = label + 1;
+    }
+    return &(body->labels[label]);
+}
+
+/* Gets the offset of a placed label, for handlers. */
+static MVMuint32 label_offset(MVMThreadContext *tc, MVMBytecodeWriterBody *body, ValueReader *vr,
+                              MVMuint64 max_labels) {
+    MVMuint32 *slot = label_slot(tc, body, vr, max_labels);
+    if (!*slot)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer frame handler refers to a label never placed");
+    return *slot - 1;
+}
+
+static MVMnum64 next_num(MVMThreadContext *tc, ValueReader *vr, MVMObject *nums) {
+    MVMuint64 num_nums = MVM_is_null(tc, nums) || !IS_CONCRETE(nums) ? 0 : MVM_repr_elems(tc, nums);
+    return MVM_repr_at_pos_n(tc, nums, next_in_range(tc, vr, num_nums, "num index"));
+}
+
+/* Writes an operand of an instruction, taking its value(s) from the
+ * instruction stream. */
+static void write_operand(MVMThreadContext *tc, MVMBytecodeWriterBody *body, ValueReader *vr,
+                          MVMuint8 flags, MVMObject *nums, const char *op_name) {
+    MVMBytecodeWriterBuffer *bc = &body->bytecode;
+    switch (flags & MVM_operand_rw_mask) {
+        case MVM_operand_read_reg:
+        case MVM_operand_write_reg:
+            write_u16(bc, (MVMuint16)next_in_range(tc, vr, 0x10000, "register"));
+            return;
+        case MVM_operand_read_lex:
+        case MVM_operand_write_lex:
+            write_u16(bc, (MVMuint16)next_in_range(tc, vr, 0x10000, "lexical index"));
+            write_u16(bc, (MVMuint16)next_in_range(tc, vr, 0x10000, "lexical outer count"));
+            return;
+    }
+    switch (flags & MVM_operand_type_mask) {
+        case MVM_operand_int8:
+            write_u8(bc, (MVMuint8)next_value(tc, vr));
+            break;
+        case MVM_operand_int16:
+            write_u16(bc, (MVMuint16)next_value(tc, vr));
+            break;
+        case MVM_operand_int32:
+            write_u32(bc, (MVMuint32)next_value(tc, vr));
+            break;
+        case MVM_operand_int64:
+            write_u64(bc, (MVMuint64)next_value(tc, vr));
+            break;
+        case MVM_operand_num32: {
+            MVMnum32  value = (MVMnum32)next_num(tc, vr, nums);
+            MVMuint32 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            write_u32(bc, bits);
+            break;
+        }
+        case MVM_operand_num64: {
+            MVMnum64  value = next_num(tc, vr, nums);
+            MVMuint64 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            write_u64(bc, bits);
+            break;
+        }
+        case MVM_operand_str:
+            write_u32(bc, next_string(tc, body, vr));
+            break;
+        case MVM_operand_ins: {
+            /* Labels may come later in the frame, so fix these up at the
+             * end of it. */
+            MVMuint32 *slot  = label_slot(tc, body, vr, vr->elems);
+            MVMuint32  label = (MVMuint32)(slot - body->labels);
+            MVM_VECTOR_PUSH(body->label_fixups, (MVMuint32)bc->data_num);
+            MVM_VECTOR_PUSH(body->label_fixups, label);
+            write_u32(bc, 0);
+            break;
+        }
+        case MVM_operand_coderef:
+            write_u16(bc, (MVMuint16)next_in_range(tc, vr, 0x10000, "frame index"));
+            break;
+        case MVM_operand_callsite:
+            write_u16(bc, (MVMuint16)next_in_range(tc, vr, body->callsite_offsets_num, "callsite index"));
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc,
+                "Bytecode writer cannot write a literal operand of op '%s' of this type", op_name);
+    }
+}
+
+/* Reads the name and operand descriptor of an extension op from the
+ * instruction stream, adding a record for it if this is its first use, and
+ * returns its opcode. The operands allowed are those the loader accepts,
+ * except literal strings, which it sizes differently from the validator. */
+static MVMuint16 extop_opcode(MVMThreadContext *tc, MVMBytecodeWriterBody *body, ValueReader *vr,
+                              MVMuint8 *descriptor) {
+    MVMuint32 name = next_string(tc, body, vr);
+    MVMuint32 num_operands = next_in_range(tc, vr, 9, "number of extension op operands");
+    MVMuint32 i;
+    memset(descriptor, 0, 8);
+    for (i = 0; i < num_operands; i++) {
+        MVMuint8 flags = (MVMuint8)next_in_range(tc, vr, 0x100, "extension op operand");
+        MVMuint8 type  = flags & MVM_operand_type_mask;
+        switch (flags & MVM_operand_rw_mask) {
+            case MVM_operand_literal:
+                if (type == MVM_operand_int8 || type == MVM_operand_int16
+                        || type == MVM_operand_int32 || type == MVM_operand_int64
+                        || type == MVM_operand_num32 || type == MVM_operand_num64
+                        || type == MVM_operand_coderef)
+                    break;
+                MVM_exception_throw_adhoc(tc,
+                    "Bytecode writer cannot write an extension op with literal operand type %d", type);
+            case MVM_operand_read_reg:
+            case MVM_operand_write_reg:
+            case MVM_operand_read_lex:
+            case MVM_operand_write_lex:
+                if (type == MVM_operand_ins || type == MVM_operand_callsite
+                        || type == MVM_operand_coderef || type == MVM_operand_spesh_slot || !type)
+                    MVM_exception_throw_adhoc(tc,
+                        "Bytecode writer cannot write an extension op with register type %d", type);
+                break;
+            default:
+                MVM_exception_throw_adhoc(tc,
+                    "Bytecode writer cannot write an extension op operand with flags %d", flags);
+        }
+        descriptor[i] = flags;
+    }
+
+    /* Find the op's record, making sure all its uses agree on operands. */
+    for (i = 0; i < body->num_extops; i++) {
+        MVMuint8 *record = body->extops.data + i * EXTOP_RECORD_SIZE;
+        if ((record[0] | record[1] << 8 | record[2] << 16 | (MVMuint32)record[3] << 24) == name) {
+            if (memcmp(record + 4, descriptor, 8) != 0)
+                MVM_exception_throw_adhoc(tc,
+                    "Bytecode writer extension op is used with differing operands");
+            return (MVMuint16)(MVM_OP_EXT_BASE + i);
+        }
+    }
+    if (body->num_extops >= 0x10000 - MVM_OP_EXT_BASE)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer cannot write more extension ops");
+    write_u32(&body->extops, name);
+    write_bytes(&body->extops, descriptor, 8);
+    return (MVMuint16)(MVM_OP_EXT_BASE + body->num_extops++);
+}
+
+/* Drops anything left from a frame that failed part way, so that only
+ * complete frames are ever written or assembled. */
+static void drop_partial_frame(MVMBytecodeWriterBody *body) {
+    body->frames.data_num      = body->frames_size;
+    body->bytecode.data_num    = body->bytecode_size;
+    body->annotations.data_num = body->annotations_size;
+    if (body->labels_num)
+        memset(body->labels, 0, body->labels_num * sizeof(MVMuint32));
+    MVM_VECTOR_CLEAR(body->labels);
+    MVM_VECTOR_CLEAR(body->label_fixups);
+}
+
+/* Adds a frame, returning its index. The info array holds, in order: the
+ * string heap indexes of the compilation unit ID and name; the index of the
+ * outer frame, or -1 for none; the frame flags; the code object SC
+ * dependency and object indexes; the number of locals followed by their
+ * types; the number of lexicals followed by a type and name for each; the
+ * number of handlers followed by the start label, end label, category mask,
+ * action, block register, goto label and label register of each; the
+ * number of static lexical values followed by the lexical index, flags, SC
+ * index and object index of each; and the number of debug names followed by
+ * a local index and name for each.
+ *
+ * The instruction stream holds each opcode followed by a value for each of
+ * its operands (two for a lexical: the index and outer count). Literal
+ * strings are string heap indexes, nums are indexes into the nums array,
+ * jump targets are label IDs, which count from 0 in each frame, and code
+ * refs are frame indexes. A label is placed with MVM_BYTECODE_WRITER_LABEL
+ * and its ID; MVM_BYTECODE_WRITER_ANNOTATE, a file name string index and a
+ * line number annotate the instructions that follow. An extension op is
+ * MVM_BYTECODE_WRITER_EXTOP, the string heap index of its name, its number
+ * of operands and their flags, then the values of its operands. */
+MVMint64 MVM_bytecode_writer_frame(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                   MVMObject *info, MVMObject *code, MVMObject *nums) {
+    MVMBytecodeWriterBody *body = &writer->body;
+    ValueReader ir, cr;
+    MVMuint32   frame_idx = body->num_frames;
+    MVMuint32   num_annotations = 0, num_locals, num_handlers, num_slvs, num_debug_names, i;
+    MVMuint32   bytecode_start, bytecode_size;
+    size_t      header_pos;
+
+    if (frame_idx > 0xFFFF)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer cannot write more than 65536 frames");
+    init_reader(tc, &ir, info, "frame info");
+    init_reader(tc, &cr, code, "instruction stream");
+
+    drop_partial_frame(body);
+
+    /* Write the instructions. */
+    bytecode_start = (MVMuint32)body->bytecode.data_num;
+    while (cr.pos < cr.elems) {
+        MVMint64 opcode = next_value(tc, &cr);
+        if (opcode == MVM_BYTECODE_WRITER_LABEL) {
+            MVMuint32 *slot = label_slot(tc, body, &cr, cr.elems);
+            if (*slot)
+                MVM_exception_throw_adhoc(tc, "Bytecode writer frame places a label twice");
+            *slot = (MVMuint32)body->bytecode.data_num - bytecode_start + 1;
+        }
+        else if (opcode == MVM_BYTECODE_WRITER_ANNOTATE) {
+            write_u32(&body->annotations, (MVMuint32)body->bytecode.data_num - bytecode_start);
+            write_u32(&body->annotations, next_string(tc, body, &cr));
+            write_u32(&body->annotations, next_in_range(tc, &cr, 0x100000000ULL, "line number"));
+            num_annotations++;
+        }
+        else if (opcode == MVM_BYTECODE_WRITER_EXTOP) {
+            MVMuint8 descriptor[8];
+            write_u16(&body->bytecode, extop_opcode(tc, body, &cr, descriptor));
+            for (i = 0; i < 8 && descriptor[i]; i++)
+                write_operand(tc, body, &cr, descriptor[i], nums, "extension op");
+        }
+        else {
+            const MVMOpInfo *op_info = opcode >= 0 && opcode < MVM_OP_sp_guard
+                ? MVM_op_get_op((unsigned short)opcode)
+                : NULL;
+            if (!op_info)
+                MVM_exception_throw_adhoc(tc, "Bytecode writer cannot write op %"PRId64, opcode);
+            write_u16(&body->bytecode, (MVMuint16)opcode);
+            for (i = 0; i < op_info->num_operands; i++)
+                write_operand(tc, body, &cr, op_info->operands[i], nums, op_info->name);
+        }
+    }
+    bytecode_size = (MVMuint32)body->bytecode.data_num - bytecode_start;
+    if (!bytecode_size)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer frame has no instructions");
+    for (i = 0; i < body->label_fixups_num; i += 2) {
+        MVMuint32 target = body->labels[body->label_fixups[i + 1]];
+        if (!target)
+            MVM_exception_throw_adhoc(tc, "Bytecode writer frame jumps to a label never placed");
+        patch_u32(&body->bytecode, body->label_fixups[i], target - 1);
+    }
+
+    /* Write the frame record, filling in its header once all is known. */
+    header_pos = body->frames.data_num;
+    write_zeroes(&body->frames, FRAME_HEADER_SIZE);
+    patch_u32(&body->frames, header_pos, bytecode_start);
+    patch_u32(&body->frames, header_pos + 4, bytecode_size);
+    patch_u32(&body->frames, header_pos + 16, next_string(tc, body, &ir));
+    patch_u32(&body->frames, header_pos + 20, next_string(tc, body, &ir));
+    {
+        MVMint64 outer = next_value(tc, &ir);
+        if (outer < -1 || outer > 0xFFFF)
+            MVM_exception_throw_adhoc(tc, "Bytecode writer frame has outer %"PRId64" out of range", outer);
+        patch_u16(&body->frames, header_pos + 24, (MVMuint16)(outer == -1 ? frame_idx : outer));
+    }
+    patch_u32(&body->frames, header_pos + 26, (MVMuint32)body->annotations_size);
+    patch_u32(&body->frames, header_pos + 30, num_annotations);
+    patch_u16(&body->frames, header_pos + 38, (MVMuint16)next_in_range(tc, &ir, 0x10000, "flags"));
+    patch_u32(&body->frames, header_pos + 42, (MVMuint32)next_value(tc, &ir));
+    patch_u32(&body->frames, header_pos + 46, (MVMuint32)next_value(tc, &ir));
+
+    num_locals = next_in_range(tc, &ir, 0x10001, "number of locals");
+    patch_u32(&body->frames, header_pos + 8, num_locals);
+    for (i = 0; i < num_locals; i++)
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "local type"));
+
+    {
+        MVMuint32 num_lexicals = next_in_range(tc, &ir, 0x10000, "number of lexicals");
+        patch_u32(&body->frames, header_pos + 12, num_lexicals);
+        for (i = 0; i < num_lexicals; i++) {
+            write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "lexical type"));
+            write_u32(&body->frames, next_string(tc, body, &ir));
+        }
+    }
+
+    num_handlers = next_in_range(tc, &ir, ir.elems, "number of handlers");
+    patch_u32(&body->frames, header_pos + 34, num_handlers);
+    for (i = 0; i < num_handlers; i++) {
+        MVMuint32 category;
+        write_u32(&body->frames, label_offset(tc, body, &ir, cr.elems));
+        write_u32(&body->frames, label_offset(tc, body, &ir, cr.elems));
+        category = (MVMuint32)next_value(tc, &ir);
+        write_u32(&body->frames, category);
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "handler action"));
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "register"));
+        write_u32(&body->frames, label_offset(tc, body, &ir, cr.elems));
+        if (category & MVM_EX_CAT_LABELED)
+            write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "register"));
+        else
+            next_value(tc, &ir);
+    }
+
+    num_slvs = next_in_range(tc, &ir, 0x10000, "number of static lexical values");
+    patch_u16(&body->frames, header_pos + 40, (MVMuint16)num_slvs);
+    for (i = 0; i < num_slvs; i++) {
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "lexical index"));
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "static lexical flags"));
+        write_u32(&body->frames, (MVMuint32)next_value(tc, &ir));
+        write_u32(&body->frames, (MVMuint32)next_value(tc, &ir));
+    }
+
+    num_debug_names = next_in_range(tc, &ir, 0x10000, "number of debug names");
+    patch_u32(&body->frames, header_pos + 50, num_debug_names);
+    for (i = 0; i < num_debug_names; i++) {
+        write_u16(&body->frames, (MVMuint16)next_in_range(tc, &ir, 0x10000, "local index"));
+        write_u32(&body->frames, next_string(tc, body, &ir));
+    }
+    if (ir.pos != ir.elems)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer frame info has trailing values");
+
+    /* The frame is complete. */
+    body->frames_size      = body->frames.data_num;
+    body->bytecode_size    = body->bytecode.data_num;
+    body->annotations_size = body->annotations.data_num;
+    body->num_frames++;
+    return frame_idx;
+}
+
+/* Pads the output to where the next section may start. */
+static void align_section(MVMBytecodeWriterBuffer *out) {
+    write_zeroes(out, MVM_ALIGN_SECTION(out->data_num) - out->data_num);
+}
+
+/* Assembles the compilation unit, returning it in a new buffer of the given
+ * type. The info array holds the string heap index of the HLL name, the
+ * indexes + 1 of the mainline, main, load and deserialize frames (0 for
+ * none), then the string heap indexes of the handles of the SCs the
+ * compilation unit depends on. The serialized data, if any, is a buffer as
+ * produced by serializetobuf from this writer's string heap. */
+MVMObject * MVM_bytecode_writer_assemble(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                         MVMObject *info, MVMObject *serialized, MVMObject *buf_type) {
+    MVMBytecodeWriterBody   *body;
+    MVMBytecodeWriterBuffer  out;
+    MVMArrayREPRData        *repr_data;
+    ValueReader  ir;
+    MVMuint8    *sc_data = NULL;
+    MVMuint64    sc_size = 0;
+    MVMuint32    header[24], i;
+    char       **encoded;
+    MVMuint64   *encoded_sizes;
+    MVMuint64    heap_size = 0;
+    MVMObject   *result;
+
+    MVMROOT3(tc, writer, serialized, buf_type, {
+        sync_strings(tc, writer);
+    });
+    body = &writer->body;
+    drop_partial_frame(body);
+
+    /* Check all inputs before writing anything. */
+    if (!body->num_frames)
+        MVM_exception_throw_adhoc(tc, "Bytecode writer has no frames to assemble");
+    if (REPR(buf_type)->ID != MVM_REPR_ID_VMArray
+            || !(repr_data = (MVMArrayREPRData *)STABLE(buf_type)->REPR_data)
+            || (repr_data->slot_type != MVM_ARRAY_U8 && repr_data->slot_type != MVM_ARRAY_I8))
+        MVM_exception_throw_adhoc(tc, "Bytecode writer can only assemble into a native 8-bit int array");
+    if (!MVM_is_null(tc, serialized) && IS_CONCRETE(serialized)) {
+        if (REPR(serialized)->ID != MVM_REPR_ID_VMArray
+                || !(repr_data = (MVMArrayREPRData *)STABLE(serialized)->REPR_data)
+                || (repr_data->slot_type != MVM_ARRAY_U8 && repr_data->slot_type != MVM_ARRAY_I8))
+            MVM_exception_throw_adhoc(tc, "Bytecode writer serialized data must be a native 8-bit int array");
+        sc_data = ((MVMArray *)serialized)->body.slots.u8 + ((MVMArray *)serialized)->body.start;
+        sc_size = ((MVMArray *)serialized)->body.elems;
+    }
+    init_reader(tc, &ir, info, "compilation unit info");
+    memset(header, 0, sizeof(header));
+    header[19] = next_string(tc, body, &ir);
+    for (i = 20; i < 24; i++)
+        header[i] = next_in_range(tc, &ir, (MVMuint64)body->num_frames + 1, "special frame index");
+    for (i = ir.pos; i < ir.elems; i++)
+        next_string(tc, body, &ir);
+
+    /* Encode the strings as ASCII where they can be, as that needs no
+     * decoding when loaded; \r\n is decoded to a single grapheme, so can
+     * only be in UTF-8. */
+    encoded       = MVM_malloc((body->num_indexed ? body->num_indexed : 1) * sizeof(char *));
+    encoded_sizes = MVM_malloc((body->num_indexed ? body->num_indexed : 1) * sizeof(MVMuint64));
+    for (i = 0; i < body->num_indexed; i++) {
+        MVMString *str = MVM_repr_at_pos_s(tc, body->strings, i);
+        encoded[i] = str
+            ? MVM_string_utf8_encode(tc, str, &(encoded_sizes[i]), 0)
+            : MVM_calloc(1, 1);
+        if (!str)
+            encoded_sizes[i] = 0;
+        heap_size += 4 + ((encoded_sizes[i] + 3) & ~(MVMuint64)3);
+        if (encoded_sizes[i] >= MAX_STRING_BYTES || heap_size > 0xFFFFFFFF) {
+            MVMuint32 failed   = i;
+            MVMuint8  too_long = encoded_sizes[i] >= MAX_STRING_BYTES;
+            for (i = 0; i <= failed; i++)
+                MVM_free(encoded[i]);
+            MVM_free(encoded);
+            MVM_free(encoded_sizes);
+            if (too_long)
+                MVM_exception_throw_adhoc(tc,
+                    "Bytecode writer cannot write string %"PRIu32" of 1 GiB or more", failed);
+            MVM_exception_throw_adhoc(tc, "Bytecode writer string heap would exceed 4 GiB");
+        }
+    }
+
+    /* Lay out the sections after the header. */
+    MVM_VECTOR_INIT(out.data, HEADER_SIZE + body->extops.data_num + body->frames.data_num
+        + body->callsites.data_num
+        + body->bytecode.data_num + body->annotations.data_num + sc_size + 1024);
+    write_zeroes(&out, HEADER_SIZE);
+    align_section(&out);
+
+    header[3] = (MVMuint32)out.data_num;
+    header[4] = (MVMuint32)(ir.elems - 5);
+    for (ir.pos = 5; ir.pos < ir.elems; )
+        write_u32(&out, next_string(tc, body, &ir));
+    align_section(&out);
+
+    header[5] = (MVMuint32)out.data_num;
+    header[6] = body->num_extops;
+    write_bytes(&out, body->extops.data, body->extops.data_num);
+    align_section(&out);
+
+    header[7] = (MVMuint32)out.data_num;
+    header[8] = body->num_frames;
+    write_bytes(&out, body->frames.data, body->frames.data_num);
+    align_section(&out);
+
+    header[9]  = (MVMuint32)out.data_num;
+    header[10] = (MVMuint32)body->callsite_offsets_num;
+    write_bytes(&out, body->callsites.data, body->callsites.data_num);
+    align_section(&out);
+
+    header[11] = (MVMuint32)out.data_num;
+    header[12] = body->num_indexed;
+    {
+        MVMuint32 offset = 0;
+        for (i = 0; i < body->num_indexed; i++) {
+            write_u32(&out, offset);
+            offset += 4 + (MVMuint32)((encoded_sizes[i] + 3) & ~(MVMuint64)3);
+        }
+    }
+    for (i = 0; i < body->num_indexed; i++) {
+        MVMuint32 encoding = MVM_CU_STRING_ASCII;
+        MVMuint64 j;
+        for (j = 0; j < encoded_sizes[i]; j++) {
+            MVMuint8 byte = (MVMuint8)encoded[i][j];
+            if (byte >= 0x80 || (byte == '\r' && j + 1 < encoded_sizes[i] && encoded[i][j + 1] == '\n')) {
+                encoding = MVM_CU_STRING_UTF8;
+                break;
+            }
+        }
+        write_u32(&out, ((MVMuint32)encoded_sizes[i] << 2) | encoding);
+        write_bytes(&out, encoded[i], encoded_sizes[i]);
+        write_zeroes(&out, (4 - (encoded_sizes[i] & 3)) & 3);
+        MVM_free(encoded[i]);
+    }
+    MVM_free(encoded);
+    MVM_free(encoded_sizes);
+    align_section(&out);
+
+    if (sc_size) {
+        header[13] = (MVMuint32)out.data_num;
+        header[14] = (MVMuint32)sc_size;
+        write_bytes(&out, sc_data, sc_size);
+        align_section(&out);
+    }
+
+    header[15] = (MVMuint32)out.data_num;
+    header[16] = (MVMuint32)body->bytecode.data_num;
+    write_bytes(&out, body->bytecode.data, body->bytecode.data_num);
+    align_section(&out);
+
+    header[17] = (MVMuint32)out.data_num;
+    header[18] = (MVMuint32)body->annotations.data_num;
+    write_bytes(&out, body->annotations.data, body->annotations.data_num);
+
+    /* Fill in the header. */
+    memcpy(out.data, "MOARVM\r\n", 8);
+    header[2] = BYTECODE_VERSION;
+    for (i = 2; i < 24; i++)
+        patch_u32(&out, i * 4, header[i]);
+
+    /* Hand back the result. */
+    result = REPR(buf_type)->allocate(tc, STABLE(buf_type));
+    if (REPR(result)->initialize)
+        REPR(result)->initialize(tc, STABLE(result), result, OBJECT_BODY(result));
+    MVM_repr_pos_set_elems(tc, result, out.data_num);
+    REPR(result)->pos_funcs.write_buf(tc, STABLE(result), result, OBJECT_BODY(result),
+        (char *)out.data, 0, out.data_num);
+    MVM_VECTOR_DESTROY(out.data);
+    return result;
+}
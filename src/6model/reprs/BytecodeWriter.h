@@ -0,0 +1,70 @@
+/* Representation used for a VM-provided bytecode writer, which assembles a
+ * compilation unit in the format src/core/bytecode.c reads, from compact
+ * instruction streams built by a compiler. */
+
+/* A growable byte buffer. */
+struct MVMBytecodeWriterBuffer {
+    MVM_VECTOR_DECL(MVMuint8, data);
+};
+
+struct MVMBytecodeWriterBody {
+    /* The string heap, which is also handed to the serializer so the SC
+     * data shares it, and a hash mapping each string to its heap index. The
+     * first num_indexed strings of the heap are in the hash. */
+    MVMObject *strings;
+    MVMObject *string_indexes;
+    MVMuint32  num_indexed;
+
+    /* The frame records, the bytecode of all frames, and the annotations;
+     * along with their sizes as of the last frame that was added, so that
+     * a frame that fails to assemble part way can be dropped again. */
+    MVMBytecodeWriterBuffer frames;
+    MVMBytecodeWriterBuffer bytecode;
+    MVMBytecodeWriterBuffer annotations;
+    size_t frames_size;
+    size_t bytecode_size;
+    size_t annotations_size;
+    MVMuint32 num_frames;
+
+    /* The callsite records and where each starts, together with a hash
+     * table of callsite index + 1 by contents, so each distinct callsite
+     * is only written once. */
+    MVMBytecodeWriterBuffer callsites;
+    MVM_VECTOR_DECL(MVMuint32, callsite_offsets);
+    MVMuint32 *callsite_table;
+    MVMuint32  callsite_table_size;
+
+    /* The extension op records, each the string heap index of the op's name
+     * and its operand descriptor, in the order of their opcodes. */
+    MVMBytecodeWriterBuffer extops;
+    MVMuint32 num_extops;
+
+    /* Label offsets (+ 1, so 0 means not yet placed) and the positions of
+     * jump targets awaiting them, for the frame being assembled. */
+    MVM_VECTOR_DECL(MVMuint32, labels);
+    MVM_VECTOR_DECL(MVMuint32, label_fixups);
+};
+struct MVMBytecodeWriter {
+    MVMObject common;
+    MVMBytecodeWriterBody body;
+};
+
+/* Function for REPR setup. */
+const MVMREPROps * MVMBytecodeWriter_initialize(MVMThreadContext *tc);
+
+/* Pseudo-instructions that may appear in an instruction stream in place of
+ * an opcode. */
+#define MVM_BYTECODE_WRITER_LABEL    -1
+#define MVM_BYTECODE_WRITER_ANNOTATE -2
+#define MVM_BYTECODE_WRITER_EXTOP    -3
+
+/* Operations on a BytecodeWriter object. */
+void MVM_bytecode_writer_ensure_writer(MVMThreadContext *tc, MVMObject *writer, const char *op);
+MVMint64 MVM_bytecode_writer_string(MVMThreadContext *tc, MVMBytecodeWriter *writer, MVMString *str);
+MVMObject * MVM_bytecode_writer_strings(MVMThreadContext *tc, MVMBytecodeWriter *writer);
+MVMint64 MVM_bytecode_writer_callsite(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                      MVMObject *flags, MVMObject *names);
+MVMint64 MVM_bytecode_writer_frame(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                   MVMObject *info, MVMObject *code, MVMObject *nums);
+MVMObject * MVM_bytecode_writer_assemble(MVMThreadContext *tc, MVMBytecodeWriter *writer,
+                                         MVMObject *info, MVMObject *serialized, MVMObject *buf_type);
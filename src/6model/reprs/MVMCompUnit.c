@@ -79,6 +79,7 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     uv_mutex_destroy(body->inline_tweak_mutex);
     MVM_free(body->inline_tweak_mutex);
     MVM_free(body->coderefs);
+    MVM_free(body->frame_offsets);
     if (body->callsites)
         MVM_fixed_size_free(tc, tc->instance->fsa,
             body->num_callsites * sizeof(MVMCallsite *),
@@ -95,6 +96,8 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVM_free(body->scs_to_resolve);
     MVM_free(body->sc_handle_idxs);
     MVM_free(body->string_heap_fast_table);
+    if (body->validation_cache)
+        MVM_validation_cache_release(tc, body->validation_cache);
     switch (body->deallocate) {
     case MVM_DEALLOCATE_NOOP:
         break;
@@ -153,7 +156,7 @@ static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data)
         size += body->data_size;
     }
 
-    size += sizeof(MVMObject *) * body->num_frames;
+    size += (sizeof(MVMObject *) + sizeof(MVMuint32)) * body->num_frames;
 
     size += sizeof(MVMExtOpRecord *) * body->num_extops;
 
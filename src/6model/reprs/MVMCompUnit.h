@@ -50,11 +50,20 @@ struct MVMCompUnitBody {
     /* See callsites, num_callsites, and orig_callsites below. */
     MVMuint16       max_callsite_size;
 
-    /* The code objects for each frame, along with counts of frames. */
+    /* The code objects for each frame, along with counts of frames. These
+     * are created on first use (see MVM_cu_coderef), so an entry is NULL
+     * until then. */
     MVMObject      **coderefs;
     MVMuint32        num_frames;    /* Total, inc. added by inliner. */
     MVMuint32        orig_frames;   /* Original from loading comp unit. */
 
+    /* Where the record of each frame starts, relative to data_start, and
+     * the segments its bytecode and annotations are in; used to create the
+     * frames. */
+    MVMuint32       *frame_offsets;
+    MVMuint8        *bytecode_seg;
+    MVMuint8        *annotation_seg;
+
     /* Special frames. */
     MVMStaticFrame  *mainline_frame;
     MVMStaticFrame  *main_frame;
@@ -92,6 +101,15 @@ struct MVMCompUnitBody {
     MVMuint32 *string_heap_fast_table;
     MVMuint32  string_heap_fast_table_top;
 
+    /* From bytecode version 8 on, the string heap starts with a table of the
+     * offset of each string, so no scanning or fast table is needed. NULL
+     * for older bytecode. */
+    MVMuint8  *string_heap_index;
+
+    /* Validation results cached on disk for this bytecode, if enabled with
+     * MVM_VALIDATION_CACHE and the unit was loaded from a file. */
+    MVMValidationCache *validation_cache;
+
     /* Refers to serialized below. sneaked in here to optimize struct layout */
     MVMint32  serialized_size;
 
@@ -25,6 +25,9 @@ typedef enum {
     /* Return from a logged callframe to an unlogged one, needed to keep
      * the spesh simulation stack in sync. */
     MVM_SPESH_LOG_RETURN_TO_UNLOGGED,
+    /* A specialization deoptimized at a deopt point often enough that it
+     * should be thrown away and re-planned. */
+    MVM_SPESH_LOG_DEOPT_STORM,
 } MVMSpeshLogEntryKind;
 
 /* Flags on types. */
@@ -84,6 +87,16 @@ struct MVMSpeshLogEntry {
             MVMuint32 bytecode_offset;
             MVMuint16 guard_index;
         } plugin;
+
+        /* Deopt storm in a specialization (DEOPT_STORM). The guard static
+         * frame is the one whose bytecode the deopt target is in, which is
+         * different from sf if the deopt happened in an inline. */
+        struct {
+            MVMStaticFrame *sf;
+            MVMSpeshCandidate *cand;
+            MVMStaticFrame *guard_sf;
+            MVMuint32 deopt_target;
+        } deopt;
     };
 };
 
@@ -27,20 +27,10 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
 
     dest_body->orig_bytecode = src_body->orig_bytecode;
     dest_body->bytecode_size = src_body->bytecode_size;
-    if (src_body->bytecode == src_body->orig_bytecode) {
-        /* Easy - the source MVMStaticFrameBody doesn't own the memory. */
-        dest_body->bytecode = src_body->bytecode;
-    }
-    else {
-        /* We're going to need to make a copy, in case the source object gets
-           GC'd before we do, and so they free memory we point to. */
-        /* If this gets to be a resource hog, then implement something more
-           sophisticated. The easiest thing would be to bump the allocated size
-           and value stored in bytecode by sizeof(MVMuint64), and use the extra
-           space to store a reference count. */
-        dest_body->bytecode = MVM_malloc(src_body->bytecode_size);
-        memcpy(dest_body->bytecode, src_body->bytecode, src_body->bytecode_size);
-    }
+    /* The clone is validated on its first invocation, which prepares its own
+     * copy of the bytecode if needed; the source's copy may already hold
+     * superinstructions, which validation would reject. */
+    dest_body->bytecode = src_body->orig_bytecode;
 
     MVM_ASSIGN_REF(tc, &(dest_root->header), dest_body->cu, src_body->cu);
     MVM_ASSIGN_REF(tc, &(dest_root->header), dest_body->cuuid, src_body->cuuid);
@@ -173,11 +163,33 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMStaticFrame *sf = (MVMStaticFrame *)obj;
     MVMStaticFrameBody *body = &sf->body;
+
+    /* Free whichever of the instrumented and uninstrumented code is not the
+     * current one; that is freed below. */
+    if (body->instrumentation) {
+        MVMStaticFrameInstrumentation *ins = body->instrumentation;
+        if (ins->uninstrumented_bytecode != body->bytecode
+                && ins->uninstrumented_bytecode != body->orig_bytecode)
+            MVM_free(ins->uninstrumented_bytecode);
+        if (ins->instrumented_bytecode != body->bytecode)
+            MVM_free(ins->instrumented_bytecode);
+        if (ins->uninstrumented_handlers != body->handlers)
+            MVM_free(ins->uninstrumented_handlers);
+        if (ins->instrumented_handlers != body->handlers)
+            MVM_free(ins->instrumented_handlers);
+        MVM_str_hash_demolish(tc, &ins->debug_locals);
+        MVM_free(ins);
+        body->instrumentation = NULL;
+    }
+
     if (body->orig_bytecode != body->bytecode) {
         MVM_free(body->bytecode);
         body->bytecode = body->orig_bytecode;
     }
-
+    if (body->predecoded) {
+        MVM_predecode_destroy(tc, body->predecoded);
+        body->predecoded = NULL;
+    }
 
     /* If it's not fully deserialized, none of the following can apply. */
     if (!body->fully_deserialized)
@@ -225,6 +237,9 @@ static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data)
         if (body->bytecode != body->orig_bytecode)
             size += body->bytecode_size;
 
+        if (body->predecoded)
+            size += MVM_predecode_allocated_size(tc, body->predecoded);
+
         size += sizeof(MVMString *) * body->num_lexicals;
 
         size += MVM_index_hash_allocated_size(tc, &body->lexical_names);
@@ -37,6 +37,10 @@ struct MVMStaticFrameBody {
 
     /* Does the frame contain specializable instructions? */
     MVMuint8 specializable;
+
+    /* How far to shift bytecode offsets right to index the inline cache, or
+     * zero if the frame has no instructions to cache for. Set by validation. */
+    MVMuint8 inline_cache_shift;
     /* Zero if the frame was never invoked. Above zero is the instrumentation
      * level the VM was atlast time the frame was invoked. See MVMInstance for
      * the VM instance wide field for this. */
@@ -105,6 +109,9 @@ struct MVMStaticFrameBody {
     /* The original bytecode for this frame (before endian swapping). */
     MVMuint8 *orig_bytecode;
 
+    /* Pre-decoded code for hot runs of simple ops in the bytecode, if any. */
+    MVMPredecoded *predecoded;
+
     /* The serialized data about this frame, used to set up the things above
      * marked (lazy). Also, once we've done that, the static lexical wvals
      * data pos; we may be able to re-use the same slot for these to. */
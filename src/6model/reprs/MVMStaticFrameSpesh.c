@@ -45,6 +45,7 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
         }
     }
     MVM_gc_worklist_add(tc, worklist, &body->plugin_state);
+    MVM_inline_cache_gc_mark(tc, &body->inline_cache, worklist);
 }
 
 /* Called by the VM in order to free memory associated with this object. */
@@ -53,6 +54,7 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMuint32 i;
     MVM_spesh_stats_destroy(tc, sfs->body.spesh_stats);
     MVM_free(sfs->body.spesh_stats);
+    MVM_free(sfs->body.deopt_storm_offsets);
     MVM_spesh_arg_guard_destroy(tc, sfs->body.spesh_arg_guard, 0);
     for (i = 0; i < sfs->body.num_spesh_candidates; i++)
         MVM_spesh_candidate_destroy(tc, sfs->body.spesh_candidates[i]);
@@ -60,6 +62,7 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
         MVM_fixed_size_free(tc, tc->instance->fsa,
             sfs->body.num_spesh_candidates * sizeof(MVMSpeshCandidate *),
             sfs->body.spesh_candidates);
+    MVM_inline_cache_destroy(tc, &sfs->body.inline_cache);
 }
 
 static const MVMStorageSpec storage_spec = {
@@ -126,6 +129,7 @@ static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data)
                 size += sizeof(MVMuint16) * code->num_locals;
         }
     }
+    size += sizeof(MVMInlineCacheEntry *) * body->inline_cache.num_entries;
     return size;
 }
 
@@ -134,6 +138,7 @@ static void describe_refs(MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTa
 
     MVM_spesh_stats_gc_describe(tc, ss, body->spesh_stats);
     MVM_spesh_arg_guard_gc_describe(tc, ss, body->spesh_arg_guard);
+    MVM_inline_cache_gc_describe(tc, ss, &body->inline_cache);
 
     if (body->num_spesh_candidates) {
         MVMuint32 i, j;
@@ -27,10 +27,24 @@ struct MVMStaticFrameSpeshBody {
      * updated atomically. */
     MVMSpeshPluginState *plugin_state;
 
+    /* Inline caches for method lookups and attribute reads done by the
+     * unspecialized bytecode. */
+    MVMInlineCache inline_cache;
+
     /* Number of times the frame was promoted to the heap, when it was not
      * specialized. Used to decide whether we'll directly allocate this frame
      * on the heap. */
     MVMuint32 num_heap_promotions;
+
+    /* Bytecode offsets (deopt targets) of logged guards that caused a deopt
+     * storm, so future specializations will not insert a guard there. Only
+     * touched by the specialization worker thread. */
+    MVMuint32 *deopt_storm_offsets;
+    MVMuint32 num_deopt_storm_offsets;
+
+    /* Number of times a candidate of this frame was thrown away due to a
+     * deopt storm; bounded to avoid endlessly re-specializing. */
+    MVMuint32 num_deopt_storms;
 };
 struct MVMStaticFrameSpesh {
     MVMObject common;
@@ -2122,6 +2122,22 @@ MVMuint16 MVM_p6opaque_get_bigint_offset(MVMThreadContext *tc, MVMSTable *st) {
     return 0;
 }
 
+/* Finds the offset into the body data of an attribute that is stored as an
+ * object reference, resolving the slot the same way get_attribute does.
+ * Returns -1 if the attribute is flattened or not found. */
+MVMint64 MVM_p6opaque_get_obj_attr_offset(MVMThreadContext *tc, MVMSTable *st,
+        MVMObject *class_handle, MVMString *name, MVMint64 hint) {
+    MVMP6opaqueREPRData *repr_data = (MVMP6opaqueREPRData *)st->REPR_data;
+    MVMint64 slot;
+    if (!repr_data)
+        return -1;
+    slot = hint >= 0 && hint < repr_data->num_attributes && !(repr_data->mi) ? hint :
+        try_get_slot(tc, repr_data, class_handle, name);
+    if (slot < 0 || repr_data->flattened_stables[slot])
+        return -1;
+    return repr_data->attribute_offsets[slot];
+}
+
 /* Gets the attribute index given we know the slot offset. */
 MVMuint32 MVM_p6opaque_offset_to_attr_idx(MVMThreadContext *tc, MVMObject *type, size_t offset) {
     MVMP6opaqueREPRData *repr_data = (MVMP6opaqueREPRData *)type->st->REPR_data;
@@ -320,7 +320,8 @@ static void get_stable_ref_info(MVMThreadContext *tc, MVMSerializationWriter *wr
 /* Expands current target storage as needed. */
 static void expand_storage_if_needed(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMint64 need) {
     if (*(writer->cur_write_offset) + need > *(writer->cur_write_limit)) {
-        *(writer->cur_write_limit) *= 2;
+        while (*(writer->cur_write_offset) + need > *(writer->cur_write_limit))
+            *(writer->cur_write_limit) *= 2;
         *(writer->cur_write_buffer) = (char *)MVM_realloc(*(writer->cur_write_buffer),
             *(writer->cur_write_limit));
     }
@@ -412,9 +413,132 @@ void MVM_serialization_write_num(MVMThreadContext *tc, MVMSerializationWriter *w
     *(writer->cur_write_offset) += 8;
 }
 
+/* The types other than those from SCs that a message may refer to. Their
+ * position in this list is how they are written. */
+static MVMObject * freezable_boot_type(MVMThreadContext *tc, MVMint64 idx) {
+    switch (idx) {
+        case 0: return tc->instance->boot_types.BOOTInt;
+        case 1: return tc->instance->boot_types.BOOTNum;
+        case 2: return tc->instance->boot_types.BOOTStr;
+        case 3: return tc->instance->boot_types.BOOTArray;
+        case 4: return tc->instance->boot_types.BOOTHash;
+        case 5: return tc->instance->boot_types.BOOTIntArray;
+        case 6: return tc->instance->boot_types.BOOTNumArray;
+        case 7: return tc->instance->boot_types.BOOTStrArray;
+        default: return NULL;
+    }
+}
+
+/* Throws an exception about a failure to freeze a message, cleaning up the
+ * writer first. */
+MVM_NO_RETURN static void fail_freeze(MVMThreadContext *tc, MVMSerializationWriter *writer,
+                          const char *messageFormat, ...) MVM_NO_RETURN_ATTRIBUTE MVM_FORMAT(printf, 3, 4);
+MVM_NO_RETURN static void fail_freeze(MVMThreadContext *tc, MVMSerializationWriter *writer,
+        const char *messageFormat, ...) {
+    va_list args;
+    MVM_ptr_hash_demolish(tc, &(writer->frozen_objects));
+    MVM_ptr_hash_demolish(tc, &(writer->frozen_stables));
+    MVM_free(writer->root.objects_data);
+    MVM_free(writer);
+    MVM_gc_allocate_gen2_default_clear(tc);
+    va_start(args, messageFormat);
+    MVM_exception_throw_adhoc_va(tc, messageFormat, args);
+    va_end(args);
+}
+
+/* Messages have no string heap, so strings are written in place as their
+ * length in bytes (-1 for a null string) and then their UTF-8. */
+static void freeze_write_str(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMString *value) {
+    if (value) {
+        MVMuint64  size;
+        char      *utf8 = MVM_string_utf8_encode(tc, value, &size, 0);
+        MVM_serialization_write_int(tc, writer, size);
+        expand_storage_if_needed(tc, writer, size);
+        memcpy(*(writer->cur_write_buffer) + *(writer->cur_write_offset), utf8, size);
+        *(writer->cur_write_offset) += size;
+        MVM_free(utf8);
+    }
+    else {
+        MVM_serialization_write_int(tc, writer, -1);
+    }
+}
+
+/* Writes an object into a message. The first time an object is seen, -1 is
+ * written, followed by its STable, whether it is concrete and, if so, what
+ * its REPR serializes; after that it is written as the index it got, which
+ * is how cycles and shared references survive. */
+static void freeze_write_obj_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMObject *ref) {
+    struct MVMPtrHashEntry *seen = MVM_ptr_hash_fetch(tc, &(writer->frozen_objects), ref);
+    if (seen) {
+        MVM_serialization_write_int(tc, writer, (MVMint64)seen->value);
+        return;
+    }
+    MVM_ptr_hash_insert(tc, &(writer->frozen_objects), ref, writer->num_frozen_objects++);
+    MVM_serialization_write_int(tc, writer, -1);
+    MVM_serialization_write_stable_ref(tc, writer, STABLE(ref));
+    if (IS_CONCRETE(ref)) {
+        if (!REPR(ref)->serialize)
+            fail_freeze(tc, writer,
+                "Cannot freeze an object of REPR %s (%s)", REPR(ref)->name, MVM_6model_get_debug_name(tc, ref));
+        MVM_serialization_write_int(tc, writer, 1);
+        REPR(ref)->serialize(tc, STABLE(ref), OBJECT_BODY(ref), writer);
+    }
+    else {
+        MVM_serialization_write_int(tc, writer, 0);
+    }
+}
+
+/* Writes an STable into a message. The first time it is seen, -1 is written,
+ * followed by the handle of the SC it is in and its index there, or by a
+ * null handle and its index in the freezable boot types. After that, it is
+ * written as the index it got. */
+static void freeze_write_stable_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMSTable *st) {
+    struct MVMPtrHashEntry  *seen = MVM_ptr_hash_fetch(tc, &(writer->frozen_stables), st);
+    MVMSerializationContext *sc;
+    if (seen) {
+        MVM_serialization_write_int(tc, writer, (MVMint64)seen->value);
+        return;
+    }
+    MVM_ptr_hash_insert(tc, &(writer->frozen_stables), st, writer->num_frozen_stables++);
+    MVM_serialization_write_int(tc, writer, -1);
+    sc = MVM_sc_get_stable_sc(tc, st);
+    if (sc) {
+        freeze_write_str(tc, writer, MVM_sc_get_handle(tc, sc));
+        MVM_serialization_write_int(tc, writer, MVM_sc_find_stable_idx(tc, sc, st));
+    }
+    else {
+        MVMint64   idx = 0;
+        MVMObject *type;
+        while ((type = freezable_boot_type(tc, idx)) && STABLE(type) != st)
+            idx++;
+        if (!type)
+            fail_freeze(tc, writer,
+                "Cannot freeze an object of type %s, which is not in a serialization context",
+                MVM_6model_get_stable_debug_name(tc, st));
+        freeze_write_str(tc, writer, NULL);
+        MVM_serialization_write_int(tc, writer, idx);
+    }
+}
+
+/* Writes a code object into a message; only static code objects that are in
+ * an SC can be, as the handle of that and their index there. */
+static void freeze_write_code_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMObject *code) {
+    MVMSerializationContext *sc = MVM_sc_get_obj_sc(tc, code);
+    if (!sc || !((MVMCode *)code)->body.is_static)
+        fail_freeze(tc, writer,
+            "Cannot freeze a closure or a code object that is not in a serialization context");
+    freeze_write_str(tc, writer, MVM_sc_get_handle(tc, sc));
+    MVM_serialization_write_int(tc, writer, MVM_sc_find_code_idx(tc, sc, code));
+}
+
 /* Writing function for native strings. */
 void MVM_serialization_write_str(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMString *value) {
-    MVMint32 heap_loc = add_string_to_heap(tc, writer, value);
+    MVMint32 heap_loc;
+    if (writer->freezing) {
+        freeze_write_str(tc, writer, value);
+        return;
+    }
+    heap_loc = add_string_to_heap(tc, writer, value);
 
     /* avoid warnings that heap_loc > STRING_HEAP_LOC_MAX is always false */
     if (!(heap_loc >= 0 && heap_loc <= STRING_HEAP_LOC_MAX)) {
@@ -459,6 +583,10 @@ static void write_locate_sc_and_index(MVMThreadContext *tc, MVMSerializationWrit
 static void write_obj_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMObject *ref) {
     MVMint32 sc_id, idx;
 
+    if (writer->freezing) {
+        freeze_write_obj_ref(tc, writer, ref);
+        return;
+    }
     if (OBJ_IS_NULL(MVM_sc_get_obj_sc(tc, ref))) {
         /* This object doesn't belong to an SC yet, so it must be serialized as part of
          * this compilation unit. Add it to the work list. */
@@ -538,9 +666,15 @@ static void write_hash_str_var(MVMThreadContext *tc, MVMSerializationWriter *wri
 
 /* Writes a reference to a code object in some SC. */
 static void write_code_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMObject *code) {
-    MVMSerializationContext *sc = MVM_sc_get_obj_sc(tc, code);
-    MVMint32  sc_id   = get_sc_id(tc, writer, sc);
-    MVMint32  idx     = (MVMint32)MVM_sc_find_code_idx(tc, sc, code);
+    MVMSerializationContext *sc;
+    MVMint32 sc_id, idx;
+    if (writer->freezing) {
+        freeze_write_code_ref(tc, writer, code);
+        return;
+    }
+    sc    = MVM_sc_get_obj_sc(tc, code);
+    sc_id = get_sc_id(tc, writer, sc);
+    idx   = (MVMint32)MVM_sc_find_code_idx(tc, sc, code);
     write_locate_sc_and_index(tc, writer, sc_id, idx);
 }
 MVM_NO_RETURN void throw_closure_serialization_error(MVMThreadContext *tc, MVMCode *closure, const char *message) MVM_NO_RETURN_ATTRIBUTE;
@@ -716,6 +850,16 @@ void MVM_serialization_write_ref(MVMThreadContext *tc, MVMSerializationWriter *w
     else if (STABLE(ref) == STABLE(tc->instance->boot_types.BOOTStr) && IS_CONCRETE(ref)) {
         discrim = REFVAR_VM_STR;
     }
+    else if (writer->freezing) {
+        /* Messages write arrays and hashes as objects too, so they keep
+         * their identity, and closures can't be frozen at all. */
+        if (REPR(ref)->ID == MVM_REPR_ID_MVMCode && IS_CONCRETE(ref))
+            discrim = REFVAR_STATIC_CODEREF;
+        else if (REPR(ref)->ID == MVM_REPR_ID_SCRef && IS_CONCRETE(ref))
+            discrim = REFVAR_SC_REF;
+        else
+            discrim = REFVAR_OBJECT;
+    }
     else if (STABLE(ref) == STABLE(tc->instance->boot_types.BOOTArray) && IS_CONCRETE(ref)) {
         discrim = REFVAR_VM_ARR_VAR;
     }
@@ -807,120 +951,143 @@ void MVM_serialization_write_ref(MVMThreadContext *tc, MVMSerializationWriter *w
 /* Writing function for references to STables. */
 void MVM_serialization_write_stable_ref(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMSTable *st) {
     MVMuint32 sc_id, idx;
+    if (writer->freezing) {
+        freeze_write_stable_ref(tc, writer, st);
+        return;
+    }
     get_stable_ref_info(tc, writer, st, &sc_id, &idx);
     write_locate_sc_and_index(tc, writer, sc_id, idx);
 }
 
+/* The serialized output is the header followed by these segments, in the
+ * order the header lists them, each starting at an aligned offset. */
+#define NUM_OUTPUT_SEGMENTS 10
+typedef struct {
+    char      **data;
+    MVMuint32   size;
+} OutputSegment;
+
+/* Where the output goes to: a C buffer, a buffer object, or a file handle. */
+typedef struct {
+    char      *buffer;
+    MVMObject *object;
+    MVMuint64  offset;
+} OutputTarget;
+typedef void (*OutputEmitter)(MVMThreadContext *tc, OutputTarget *target, char *data, MVMuint32 size);
+
+/* Works out where each segment goes and fills in the header to match.
+ * Returns the total output size. */
+static MVMuint32 layout_outputs(MVMSerializationWriter *writer, char *header, OutputSegment *segments) {
+    MVMuint32 offsets[NUM_OUTPUT_SEGMENTS];
+    MVMuint32 offset = MVM_ALIGN_SECTION(HEADER_SIZE);
+    MVMuint32 i;
+
+    segments[0].data = &(writer->root.dependencies_table);
+    segments[0].size = writer->root.num_dependencies * DEP_TABLE_ENTRY_SIZE;
+    segments[1].data = &(writer->root.stables_table);
+    segments[1].size = writer->root.num_stables * STABLES_TABLE_ENTRY_SIZE;
+    segments[2].data = &(writer->root.stables_data);
+    segments[2].size = writer->stables_data_offset;
+    segments[3].data = &(writer->root.objects_table);
+    segments[3].size = writer->root.num_objects * OBJECTS_TABLE_ENTRY_SIZE;
+    segments[4].data = &(writer->root.objects_data);
+    segments[4].size = writer->objects_data_offset;
+    segments[5].data = &(writer->root.closures_table);
+    segments[5].size = writer->root.num_closures * CLOSURES_TABLE_ENTRY_SIZE;
+    segments[6].data = &(writer->root.contexts_table);
+    segments[6].size = writer->root.num_contexts * CONTEXTS_TABLE_ENTRY_SIZE;
+    segments[7].data = &(writer->root.contexts_data);
+    segments[7].size = writer->contexts_data_offset;
+    segments[8].data = &(writer->root.repos_table);
+    segments[8].size = writer->root.num_repos * REPOS_TABLE_ENTRY_SIZE;
+    segments[9].data = &(writer->root.param_interns_data);
+    segments[9].size = writer->param_interns_data_offset;
+    for (i = 0; i < NUM_OUTPUT_SEGMENTS; i++) {
+        offsets[i] = offset;
+        offset    += MVM_ALIGN_SECTION(segments[i].size);
+    }
+
+    /* Version, then the location (and rows, for tables) of each segment. */
+    memset(header, 0, HEADER_SIZE);
+    write_int32(header, 0, CURRENT_VERSION);
+    write_int32(header, 4, offsets[0]);
+    write_int32(header, 8, writer->root.num_dependencies);
+    write_int32(header, 12, offsets[1]);
+    write_int32(header, 16, writer->root.num_stables);
+    write_int32(header, 20, offsets[2]);
+    write_int32(header, 24, offsets[3]);
+    write_int32(header, 28, writer->root.num_objects);
+    write_int32(header, 32, offsets[4]);
+    write_int32(header, 36, offsets[5]);
+    write_int32(header, 40, writer->root.num_closures);
+    write_int32(header, 44, offsets[6]);
+    write_int32(header, 48, writer->root.num_contexts);
+    write_int32(header, 52, offsets[7]);
+    write_int32(header, 56, offsets[8]);
+    write_int32(header, 60, writer->root.num_repos);
+    write_int32(header, 64, offsets[9]);
+    write_int32(header, 68, writer->root.num_param_interns);
+
+    return offset;
+}
+
+/* Sends the header and then each segment, padded out to alignment, to the
+ * emitter. A segment is freed as soon as it has been sent, so the output
+ * and the writer's buffers do not all have to be in memory at once. */
+static void emit_outputs(MVMThreadContext *tc, char *header, OutputSegment *segments,
+                         OutputEmitter emit, OutputTarget *target) {
+    static char padding[8] = { 0 };
+    MVMuint32 i;
+    emit(tc, target, header, HEADER_SIZE);
+    emit(tc, target, padding, MVM_ALIGN_SECTION(HEADER_SIZE) - HEADER_SIZE);
+    for (i = 0; i < NUM_OUTPUT_SEGMENTS; i++) {
+        emit(tc, target, *(segments[i].data), segments[i].size);
+        emit(tc, target, padding, MVM_ALIGN_SECTION(segments[i].size) - segments[i].size);
+        MVM_free(*(segments[i].data));
+        *(segments[i].data) = NULL;
+    }
+}
+
+static void emit_to_memory(MVMThreadContext *tc, OutputTarget *target, char *data, MVMuint32 size) {
+    if (size) {
+        memcpy(target->buffer + target->offset, data, size);
+        target->offset += size;
+    }
+}
+
+static void emit_to_buf(MVMThreadContext *tc, OutputTarget *target, char *data, MVMuint32 size) {
+    if (size) {
+        MVMObject *buf = target->object;
+        REPR(buf)->pos_funcs.write_buf(tc, STABLE(buf), buf, OBJECT_BODY(buf), data, target->offset, size);
+        target->offset += size;
+    }
+}
+
+static void emit_to_fh(MVMThreadContext *tc, OutputTarget *target, char *data, MVMuint32 size) {
+    if (size) {
+        MVM_io_write_bytes_c(tc, target->object, data, size);
+        target->offset += size;
+    }
+}
+
 /* Concatenates the various output segments into a single binary MVMString. */
 static MVMObject * concatenate_outputs(MVMThreadContext *tc, MVMSerializationWriter *writer, MVMObject *type) {
-    char      *output      = NULL;
-    char      *output_b64  = NULL;
-    MVMuint32  output_size = 0;
-    MVMuint32  offset      = 0;
-    MVMObject *result;
+    char           header[HEADER_SIZE];
+    OutputSegment  segments[NUM_OUTPUT_SEGMENTS];
+    OutputTarget   target;
+    char          *output_b64  = NULL;
+    MVMuint32      output_size = layout_outputs(writer, header, segments);
+    MVMObject     *result;
 
-    /* Calculate total size. */
-    output_size += MVM_ALIGN_SECTION(HEADER_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_dependencies * DEP_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_stables * STABLES_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->stables_data_offset);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_objects * OBJECTS_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->objects_data_offset);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_closures * CLOSURES_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_contexts * CONTEXTS_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->contexts_data_offset);
-    output_size += MVM_ALIGN_SECTION(writer->root.num_repos * REPOS_TABLE_ENTRY_SIZE);
-    output_size += MVM_ALIGN_SECTION(writer->param_interns_data_offset);
-
-    /* Allocate a buffer that size. */
-    output = (char *)MVM_calloc(1, output_size);
-
-    /* Write version into header. */
-    write_int32(output, 0, CURRENT_VERSION);
-    offset += MVM_ALIGN_SECTION(HEADER_SIZE);
-
-    /* Put dependencies table in place and set location/rows in header. */
-    write_int32(output, 4, offset);
-    write_int32(output, 8, writer->root.num_dependencies);
-    memcpy(output + offset, writer->root.dependencies_table,
-        writer->root.num_dependencies * DEP_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_dependencies * DEP_TABLE_ENTRY_SIZE);
-
-    /* Put STables table in place, and set location/rows in header. */
-    write_int32(output, 12, offset);
-    write_int32(output, 16, writer->root.num_stables);
-    memcpy(output + offset, writer->root.stables_table,
-        writer->root.num_stables * STABLES_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_stables * STABLES_TABLE_ENTRY_SIZE);
-
-    /* Put STables data in place. */
-    write_int32(output, 20, offset);
-    memcpy(output + offset, writer->root.stables_data,
-        writer->stables_data_offset);
-    offset += MVM_ALIGN_SECTION(writer->stables_data_offset);
-
-    /* Put objects table in place, and set location/rows in header. */
-    write_int32(output, 24, offset);
-    write_int32(output, 28, writer->root.num_objects);
-    memcpy(output + offset, writer->root.objects_table,
-        writer->root.num_objects * OBJECTS_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_objects * OBJECTS_TABLE_ENTRY_SIZE);
-
-    /* Put objects data in place. */
-    write_int32(output, 32, offset);
-    memcpy(output + offset, writer->root.objects_data,
-        writer->objects_data_offset);
-    offset += MVM_ALIGN_SECTION(writer->objects_data_offset);
-
-    /* Put closures table in place, and set location/rows in header. */
-    write_int32(output, 36, offset);
-    write_int32(output, 40, writer->root.num_closures);
-    memcpy(output + offset, writer->root.closures_table,
-        writer->root.num_closures * CLOSURES_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_closures * CLOSURES_TABLE_ENTRY_SIZE);
-
-    /* Put contexts table in place, and set location/rows in header. */
-    write_int32(output, 44, offset);
-    write_int32(output, 48, writer->root.num_contexts);
-    memcpy(output + offset, writer->root.contexts_table,
-        writer->root.num_contexts * CONTEXTS_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_contexts * CONTEXTS_TABLE_ENTRY_SIZE);
-
-    /* Put contexts data in place. */
-    write_int32(output, 52, offset);
-    memcpy(output + offset, writer->root.contexts_data,
-        writer->contexts_data_offset);
-    offset += MVM_ALIGN_SECTION(writer->contexts_data_offset);
-
-    /* Put repossessions table in place, and set location/rows in header. */
-    write_int32(output, 56, offset);
-    write_int32(output, 60, writer->root.num_repos);
-    memcpy(output + offset, writer->root.repos_table,
-        writer->root.num_repos * REPOS_TABLE_ENTRY_SIZE);
-    offset += MVM_ALIGN_SECTION(writer->root.num_repos * REPOS_TABLE_ENTRY_SIZE);
-
-    /* Put parameterized type intern data in place. */
-    write_int32(output, 64, offset);
-    write_int32(output, 68, writer->root.num_param_interns);
-    memcpy(output + offset, writer->root.param_interns_data,
-        writer->param_interns_data_offset);
-    offset += MVM_ALIGN_SECTION(writer->param_interns_data_offset);
-
-    /* Sanity check. */
-    if (offset != output_size) {
-        MVM_free(output);
-        MVM_gc_allocate_gen2_default_clear(tc);
-        MVM_exception_throw_adhoc(tc,
-            "Serialization sanity check failed: offset != output_size");
-    }
+    memset(&target, 0, sizeof(OutputTarget));
 
     if (type) { /* nqp::serializetobuffer */
         result = REPR(type)->allocate(tc, STABLE(type));
         if (REPR(result)->initialize)
             REPR(result)->initialize(tc, STABLE(result), result, OBJECT_BODY(result));
-        REPR(result)->pos_funcs.write_buf(tc, STABLE(result), result, OBJECT_BODY(result), output, 0, output_size);
-        MVM_free(output);
-
+        MVM_repr_pos_set_elems(tc, result, output_size);
+        target.object = result;
+        emit_outputs(tc, header, segments, emit_to_buf, &target);
         return result;
     }
 
@@ -929,13 +1096,14 @@ static MVMObject * concatenate_outputs(MVMThreadContext *tc, MVMSerializationWri
     /* If we are compiling at present, then just return for now */
     if (tc->compiling_scs && MVM_repr_elems(tc, tc->compiling_scs) &&
             MVM_repr_at_pos_o(tc, tc->compiling_scs, 0) == (MVMObject *)writer->root.sc) {
-        MVM_free(output);
         return NULL;
     }
 
     /* Base 64 encode. */
-    output_b64 = base64_encode(output, output_size);
-    MVM_free(output);
+    target.buffer = (char *)MVM_malloc(output_size);
+    emit_outputs(tc, header, segments, emit_to_memory, &target);
+    output_b64 = base64_encode(target.buffer, output_size);
+    MVM_free(target.buffer);
     if (output_b64 == NULL) {
         MVM_gc_allocate_gen2_default_clear(tc);
         MVM_exception_throw_adhoc(tc,
@@ -1388,9 +1556,10 @@ static void serialize(MVMThreadContext *tc, MVMSerializationWriter *writer) {
     serialize_repossessions(tc, writer);
 }
 
-MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationContext *sc, MVMObject *empty_string_heap, MVMObject *type) {
+/* Sets up a writer and serializes the SC with it, leaving the output in the
+ * writer's segments. This enters gen2 allocation, which the caller leaves. */
+static MVMSerializationWriter * run_writer(MVMThreadContext *tc, MVMSerializationContext *sc, MVMObject *empty_string_heap) {
     MVMSerializationWriter *writer;
-    MVMObject *result   = NULL;
     MVMint32   sc_elems = (MVMint32)sc->body->num_objects;
     MVMint64 i = 0;
     MVMint64 seed_strings = MVM_repr_elems(tc, empty_string_heap);
@@ -1438,12 +1607,10 @@ MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationCo
     /* Start serializing. */
     serialize(tc, writer);
 
-    /* Build a single result out of the serialized data; note if we're in the
-     * compiler pipeline this will return null and stash the output to write
-     * to a bytecode file later. */
-    result = concatenate_outputs(tc, writer, type);
+    return writer;
+}
 
-    /* Clear up afterwards. */
+static void free_writer(MVMThreadContext *tc, MVMSerializationWriter *writer) {
     MVM_free(writer->contexts_list);
     MVM_free(writer->root.dependent_scs);
     MVM_free(writer->root.dependencies_table);
@@ -1457,13 +1624,66 @@ MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationCo
     MVM_free(writer->root.param_interns_data);
     MVM_free(writer->root.repos_table);
     MVM_free(writer);
+}
+
+MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationContext *sc, MVMObject *empty_string_heap, MVMObject *type) {
+    MVMSerializationWriter *writer = run_writer(tc, sc, empty_string_heap);
 
-    /* Exit gen2 allocation. */
+    /* Build a single result out of the serialized data; note if we're in the
+     * compiler pipeline this will return null and stash the output to write
+     * to a bytecode file later. */
+    MVMObject *result = concatenate_outputs(tc, writer, type);
+
+    /* Clear up afterwards, and exit gen2 allocation. */
+    free_writer(tc, writer);
     MVM_gc_allocate_gen2_default_clear(tc);
 
     return result;
 }
 
+/* Serializes the SC and writes the output straight to a file handle, one
+ * segment at a time, rather than joining it into a buffer first. The bytes
+ * written are the same as serializetobuf would produce. Returns how many
+ * bytes that was. */
+MVMint64 MVM_serialization_serialize_to_fh(MVMThreadContext *tc, MVMSerializationContext *sc, MVMObject *empty_string_heap, MVMObject *fh) {
+    MVMSerializationWriter *writer;
+    char          header[HEADER_SIZE];
+    OutputSegment segments[NUM_OUTPUT_SEGMENTS];
+    OutputTarget  target;
+    jmp_buf       backup_interp_jump;
+
+    /* Make sure we can write to the handle before doing all the work. */
+    if (REPR(fh)->ID != MVM_REPR_ID_MVMOSHandle || !IS_CONCRETE(fh)
+            || !((MVMOSHandle *)fh)->body.ops->sync_writable)
+        MVM_exception_throw_adhoc(tc,
+            "serializetofh requires a writable file handle (got %s with REPR %s)",
+            MVM_6model_get_debug_name(tc, fh), REPR(fh)->name);
+
+    memset(&target, 0, sizeof(OutputTarget));
+    target.object = fh;
+    MVMROOT(tc, target.object, {
+        writer = run_writer(tc, sc, empty_string_heap);
+        layout_outputs(writer, header, segments);
+
+        /* The output is plain C memory, so leave gen2 allocation before the
+         * writes, any of which may throw. Should one do so, we catch the
+         * jump back into the interpreter to free the segments not yet
+         * written, then carry on with it. */
+        MVM_gc_allocate_gen2_default_clear(tc);
+        memcpy(backup_interp_jump, tc->interp_jump, sizeof(jmp_buf));
+        if (setjmp(tc->interp_jump)) {
+            memcpy(tc->interp_jump, backup_interp_jump, sizeof(jmp_buf));
+            free_writer(tc, writer);
+            longjmp(tc->interp_jump, 1);
+        }
+        emit_outputs(tc, header, segments, emit_to_fh, &target);
+        memcpy(tc->interp_jump, backup_interp_jump, sizeof(jmp_buf));
+    });
+    free_writer(tc, writer);
+
+    return (MVMint64)target.offset;
+}
+
 
 /* ***************************************************************************
  * Deserialization (reading related)
@@ -1717,6 +1937,103 @@ MVMnum64 MVM_serialization_read_num(MVMThreadContext *tc, MVMSerializationReader
     return result;
 }
 
+/* Reads a string written in place into a message. */
+static MVMString * thaw_read_str(MVMThreadContext *tc, MVMSerializationReader *reader) {
+    MVMint64   size = MVM_serialization_read_int(tc, reader);
+    MVMString *result;
+    if (size == -1)
+        return NULL;
+    if (size < 0 || size > 0x7FFFFFFF)
+        fail_deserialize(tc, NULL, reader, "Invalid string length %"PRIi64" in message", size);
+    assert_can_read(tc, reader, (MVMint32)size);
+    result = MVM_string_utf8_decode(tc, tc->instance->VMString,
+        *(reader->cur_read_buffer) + *(reader->cur_read_offset), (size_t)size);
+    *(reader->cur_read_offset) += (MVMint32)size;
+    return result;
+}
+
+/* Finds the SC a message refers to by its handle; it must be loaded. */
+static MVMSerializationContext * thaw_locate_sc(MVMThreadContext *tc, MVMSerializationReader *reader,
+        MVMString *handle) {
+    MVMSerializationContext *sc = MVM_sc_find_by_handle(tc, handle);
+    if (!sc) {
+        char *c_handle = MVM_string_utf8_encode_C_string(tc, handle);
+        char *waste[] = { c_handle, NULL };
+        fail_deserialize(tc, waste, reader,
+            "Cannot thaw a message referring to serialization context %s, which is not loaded",
+            c_handle);
+    }
+    return sc;
+}
+
+/* Reads an object from a message; see freeze_write_obj_ref. */
+static MVMObject * thaw_read_obj_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
+    MVMint64   idx = MVM_serialization_read_int(tc, reader);
+    MVMSTable *st;
+    MVMObject *obj;
+    if (idx >= 0) {
+        if (idx >= MVM_repr_elems(tc, reader->thawed_objects))
+            fail_deserialize(tc, NULL, reader, "Invalid object index %"PRIi64" in message", idx);
+        return MVM_repr_at_pos_o(tc, reader->thawed_objects, idx);
+    }
+    if (idx != -1)
+        fail_deserialize(tc, NULL, reader, "Invalid object index %"PRIi64" in message", idx);
+
+    /* A new object; it goes in the list before reading its body, as that
+     * may refer back to it. */
+    st = MVM_serialization_read_stable_ref(tc, reader);
+    if (MVM_serialization_read_int(tc, reader)) {
+        if (!st->REPR->deserialize)
+            fail_deserialize(tc, NULL, reader, "Missing deserialize REPR function for %s (%s)",
+                st->REPR->name, MVM_6model_get_stable_debug_name(tc, st));
+        obj = st->REPR->allocate(tc, st);
+        MVM_repr_push_o(tc, reader->thawed_objects, obj);
+        st->REPR->deserialize(tc, st, obj, OBJECT_BODY(obj), reader);
+    }
+    else {
+        obj = st->WHAT;
+        MVM_repr_push_o(tc, reader->thawed_objects, obj);
+    }
+    return obj;
+}
+
+/* Reads an STable from a message; see freeze_write_stable_ref. */
+static MVMSTable * thaw_read_stable_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
+    MVMint64   idx = MVM_serialization_read_int(tc, reader);
+    MVMString *handle;
+    MVMObject *type;
+    if (idx >= 0) {
+        if (idx >= MVM_repr_elems(tc, reader->thawed_types))
+            fail_deserialize(tc, NULL, reader, "Invalid type index %"PRIi64" in message", idx);
+        return STABLE(MVM_repr_at_pos_o(tc, reader->thawed_types, idx));
+    }
+    if (idx != -1)
+        fail_deserialize(tc, NULL, reader, "Invalid type index %"PRIi64" in message", idx);
+
+    handle = thaw_read_str(tc, reader);
+    idx    = MVM_serialization_read_int(tc, reader);
+    if (handle) {
+        MVMSerializationContext *sc = thaw_locate_sc(tc, reader, handle);
+        if (idx < 0 || idx >= sc->body->num_stables)
+            fail_deserialize(tc, NULL, reader, "Invalid STable index %"PRIi64" in message", idx);
+        type = MVM_sc_get_stable(tc, sc, idx)->WHAT;
+    }
+    else if (!(type = freezable_boot_type(tc, idx))) {
+        fail_deserialize(tc, NULL, reader, "Invalid boot type index %"PRIi64" in message", idx);
+    }
+    MVM_repr_push_o(tc, reader->thawed_types, type);
+    return STABLE(type);
+}
+
+/* Reads a code object from a message; see freeze_write_code_ref. */
+static MVMObject * thaw_read_code_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
+    MVMString *handle = thaw_read_str(tc, reader);
+    MVMint64   idx    = MVM_serialization_read_int(tc, reader);
+    if (!handle)
+        fail_deserialize(tc, NULL, reader, "Missing code object SC handle in message");
+    return MVM_sc_get_code(tc, thaw_locate_sc(tc, reader, handle), idx);
+}
+
 /* Reading function for native strings.
  *
  * BEWARE - logic in this function is partly duplicated in the skip calculations
@@ -1725,6 +2042,8 @@ MVMnum64 MVM_serialization_read_num(MVMThreadContext *tc, MVMSerializationReader
 MVMString * MVM_serialization_read_str(MVMThreadContext *tc, MVMSerializationReader *reader) {
     MVMint32 offset;
 
+    if (reader->thawed_objects)
+        return thaw_read_str(tc, reader);
     assert_can_read(tc, reader, 2);
     offset = read_uint16(*(reader->cur_read_buffer), *(reader->cur_read_offset));
     *(reader->cur_read_offset) += 2;
@@ -1804,7 +2123,10 @@ MVM_STATIC_INLINE MVMSerializationContext * read_locate_sc_and_index(MVMThreadCo
  * MVM_serialization_read_ref(). */
 static MVMObject * read_obj_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
     MVMint32 idx;
-    MVMSerializationContext *sc = read_locate_sc_and_index(tc, reader, &idx);
+    MVMSerializationContext *sc;
+    if (reader->thawed_objects)
+        return thaw_read_obj_ref(tc, reader);
+    sc = read_locate_sc_and_index(tc, reader, &idx);
     /* sequence point... */
     return MVM_sc_get_object(tc, sc, idx);
 }
@@ -1916,7 +2238,10 @@ static MVMObject * read_array_str(MVMThreadContext *tc, MVMSerializationReader *
  * MVM_serialization_read_ref(). */
 static MVMObject * read_code_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
     MVMint32 idx;
-    MVMSerializationContext *sc = read_locate_sc_and_index(tc, reader, &idx);
+    MVMSerializationContext *sc;
+    if (reader->thawed_objects)
+        return thaw_read_code_ref(tc, reader);
+    sc = read_locate_sc_and_index(tc, reader, &idx);
     return MVM_sc_get_code(tc, sc, idx);
 }
 
@@ -2012,7 +2337,10 @@ MVMObject * MVM_serialization_read_ref(MVMThreadContext *tc, MVMSerializationRea
 /* Reading function for STable references. */
 MVMSTable * MVM_serialization_read_stable_ref(MVMThreadContext *tc, MVMSerializationReader *reader) {
     MVMint32 idx;
-    MVMSerializationContext *sc = read_locate_sc_and_index(tc, reader, &idx);
+    MVMSerializationContext *sc;
+    if (reader->thawed_objects)
+        return thaw_read_stable_ref(tc, reader);
+    sc = read_locate_sc_and_index(tc, reader, &idx);
     return MVM_sc_get_stable(tc, sc, idx);
 }
 
@@ -3395,12 +3723,137 @@ void MVM_serialization_deserialize(MVMThreadContext *tc, MVMSerializationContext
         MVM_serialization_demand_object(tc, sc, i);
     for (i = 0; i < sc->body->num_stables; i++)
         MVM_serialization_demand_stable(tc, sc, i);
+#else
+    /* Otherwise, let any helper threads get on with it. */
+    MVM_deserialize_worker_enqueue(tc, sc);
 #endif
 
     /* Restore normal GC allocation. */
     MVM_gc_allocate_gen2_default_clear(tc);
 }
 
+
+/* ***************************************************************************
+ * Freezing and thawing of messages
+ * ***************************************************************************/
+
+/* A message is a lighter form of serialization for sending object graphs
+ * between threads and processes: a single pass over the graph, with no SC
+ * taking ownership of the objects, no string heap and no base64. It has an
+ * 8 byte header: "MVF", the serialization format version as a byte, and the
+ * size of the rest of the message as a 32 bit integer. Then comes the root
+ * object, written as by MVM_serialization_write_ref, except that objects,
+ * STables, strings and code objects are written in place (see the freeze_
+ * functions above). Everything is copied, apart from types and static code
+ * objects, which are found by the handle of their SC when thawing. */
+#define MESSAGE_MAGIC       "MVF"
+#define MESSAGE_HEADER_SIZE 8
+
+/* Checks that a message is to be written to or read from a byte buffer. */
+static void check_message_buf(MVMThreadContext *tc, MVMObject *buf, const char *op) {
+    if (!IS_CONCRETE(buf) || REPR(buf)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "%s requires a native array", op);
+    switch (((MVMArrayREPRData *)STABLE(buf)->REPR_data)->slot_type) {
+        case MVM_ARRAY_I8:
+        case MVM_ARRAY_U8:
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc, "%s requires a native array of 8 bit integers", op);
+    }
+}
+
+/* Freezes the object graph rooted at obj into a message, appended to buf. */
+void MVM_serialization_freeze(MVMThreadContext *tc, MVMObject *obj, MVMObject *buf) {
+    MVMSerializationWriter *writer;
+    MVMuint32 size;
+
+    check_message_buf(tc, buf, "freeze");
+
+    /* We allocate in gen2 and don't hit a GC safepoint until we're done, so
+     * objects stay where they are and their addresses are good keys. */
+    MVM_gc_allocate_gen2_default_set(tc);
+
+    writer = MVM_calloc(1, sizeof(MVMSerializationWriter));
+    writer->root.version        = CURRENT_VERSION;
+    writer->freezing            = 1;
+    writer->objects_data_alloc  = 256;
+    writer->root.objects_data   = (char *)MVM_malloc(writer->objects_data_alloc);
+    writer->objects_data_offset = MESSAGE_HEADER_SIZE;
+    writer->cur_write_buffer    = &(writer->root.objects_data);
+    writer->cur_write_offset    = &(writer->objects_data_offset);
+    writer->cur_write_limit     = &(writer->objects_data_alloc);
+    MVM_ptr_hash_build(tc, &(writer->frozen_objects));
+    MVM_ptr_hash_build(tc, &(writer->frozen_stables));
+
+    MVM_serialization_write_ref(tc, writer, obj);
+
+    size = writer->objects_data_offset;
+    memcpy(writer->root.objects_data, MESSAGE_MAGIC, 3);
+    writer->root.objects_data[3] = CURRENT_VERSION;
+    write_int32(writer->root.objects_data, 4, size - MESSAGE_HEADER_SIZE);
+
+    MVM_ptr_hash_demolish(tc, &(writer->frozen_objects));
+    MVM_ptr_hash_demolish(tc, &(writer->frozen_stables));
+    MVM_gc_allocate_gen2_default_clear(tc);
+
+    REPR(buf)->pos_funcs.write_buf(tc, STABLE(buf), buf, OBJECT_BODY(buf),
+        writer->root.objects_data, MVM_repr_elems(tc, buf), size);
+    MVM_free(writer->root.objects_data);
+    MVM_free(writer);
+}
+
+/* Thaws the message starting at offset in buf, returning its root object.
+ * The next message, if any, starts 8 bytes plus the size in the header on
+ * from there. */
+MVMObject * MVM_serialization_thaw(MVMThreadContext *tc, MVMObject *buf, MVMint64 offset) {
+    MVMSerializationReader *reader;
+    MVMObject *result;
+    MVMuint8  *data;
+    MVMint64   elems;
+    MVMuint32  size;
+
+    check_message_buf(tc, buf, "thaw");
+    data  = (MVMuint8 *)(((MVMArray *)buf)->body.slots.u8 + ((MVMArray *)buf)->body.start);
+    elems = (MVMint64)((MVMArray *)buf)->body.elems;
+    if (offset < 0 || offset + MESSAGE_HEADER_SIZE > elems
+            || memcmp(data + offset, MESSAGE_MAGIC, 3) != 0)
+        MVM_exception_throw_adhoc(tc, "thaw found no message at offset %"PRIi64, offset);
+    if (data[offset + 3] < MIN_VERSION || data[offset + 3] > CURRENT_VERSION)
+        MVM_exception_throw_adhoc(tc, "thaw cannot read messages of version %d", (int)data[offset + 3]);
+    size = (MVMuint32)read_int32((char *)data, offset + 4);
+    if (size > 0x7FFFFFFF || offset + MESSAGE_HEADER_SIZE + size > elems)
+        MVM_exception_throw_adhoc(tc, "thaw found a truncated message at offset %"PRIi64, offset);
+
+    MVM_gc_allocate_gen2_default_set(tc);
+
+    /* Read from a copy, as another thread may append to the buffer, and so
+     * move its storage, while we thaw. */
+    reader = MVM_calloc(1, sizeof(MVMSerializationReader));
+    reader->root.version       = data[offset + 3];
+    reader->data               = MVM_malloc(size ? size : 1);
+    reader->data_needs_free    = 1;
+    memcpy(reader->data, data + offset + MESSAGE_HEADER_SIZE, size);
+    reader->root.objects_data  = reader->data;
+    reader->objects_data_end   = reader->data + size;
+    reader->cur_read_buffer    = &(reader->root.objects_data);
+    reader->cur_read_offset    = &(reader->objects_data_offset);
+    reader->cur_read_end       = &(reader->objects_data_end);
+    reader->thawed_objects     = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&(reader->thawed_objects));
+    reader->thawed_types       = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&(reader->thawed_types));
+
+    result = MVM_serialization_read_ref(tc, reader);
+    if (reader->objects_data_offset != (MVMint32)size)
+        fail_deserialize(tc, NULL, reader, "Trailing data after the end of a message");
+
+    MVM_gc_root_temp_pop_n(tc, 2);
+    MVM_free(reader->data);
+    MVM_free(reader);
+    MVM_gc_allocate_gen2_default_clear(tc);
+    return result;
+}
+
 /*
 
 =item sha1
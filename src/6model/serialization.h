@@ -118,6 +118,12 @@ struct MVMSerializationReader {
      * indicates when it should be. */
     char      *data;
     MVMuint32  data_needs_free;
+
+    /* When thawing a message rather than deserializing an SC, the objects
+     * and types read so far, in the order they appear in the message. NULL
+     * otherwise. */
+    MVMObject *thawed_objects;
+    MVMObject *thawed_types;
 };
 
 /* Represents the serialization writer and the various functions available
@@ -168,6 +174,14 @@ struct MVMSerializationWriter {
     char      **cur_write_buffer;
     MVMuint32  *cur_write_offset;
     MVMuint32  *cur_write_limit;
+
+    /* When freezing a message rather than serializing an SC, the objects
+     * and STables written so far, mapped to their index in the message. */
+    MVMuint32       freezing;
+    MVMPtrHashTable frozen_objects;
+    MVMuint32       num_frozen_objects;
+    MVMPtrHashTable frozen_stables;
+    MVMuint32       num_frozen_stables;
 };
 
 /* Core serialize and deserialize functions. */
@@ -177,6 +191,12 @@ void MVM_serialization_deserialize(MVMThreadContext *tc, MVMSerializationContext
 MVMString * MVM_sha1(MVMThreadContext *tc, MVMString *str);
 MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationContext *sc,
     MVMObject *empty_string_heap, MVMObject *type);
+MVMint64 MVM_serialization_serialize_to_fh(MVMThreadContext *tc, MVMSerializationContext *sc,
+    MVMObject *empty_string_heap, MVMObject *fh);
+
+/* Freezing and thawing of object graphs to and from messages. */
+void MVM_serialization_freeze(MVMThreadContext *tc, MVMObject *obj, MVMObject *buf);
+MVMObject * MVM_serialization_thaw(MVMThreadContext *tc, MVMObject *buf, MVMint64 offset);
 
 /* Functions for demanding an object/STable/code be made available (that is,
  * by lazily deserializing it). */
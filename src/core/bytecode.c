@@ -3,7 +3,7 @@
 /* Some constants. */
 #define HEADER_SIZE                 92
 #define MIN_BYTECODE_VERSION        5
-#define MAX_BYTECODE_VERSION        7
+#define MAX_BYTECODE_VERSION        8
 #define FRAME_HEADER_SIZE           (11 * 4 + 3 * 2 + (bytecode_version >= 6 ? 4 : 0))
 #define FRAME_HANDLER_SIZE          (4 * 4 + 2 * 2)
 #define FRAME_SLV_SIZE              (2 * 2 + 2 * 4)
@@ -64,9 +64,6 @@ typedef struct {
     /* The limit we can not read beyond. */
     MVMuint8 *read_limit;
 
-    /* Array of frames. */
-    MVMStaticFrame **frames;
-
     /* Special frame indexes */
     MVMuint32  mainline_frame;
     MVMuint32  main_frame;
@@ -108,7 +105,6 @@ static MVMuint8 read_int8(MVMuint8 *buffer, size_t offset) {
 
 /* Cleans up reader state. */
 static void cleanup_all(ReaderState *rs) {
-    MVM_free(rs->frames);
     MVM_free(rs->frame_outer_fixups);
     MVM_free(rs);
 }
@@ -202,6 +198,10 @@ static ReaderState * dissect_bytecode(MVMThreadContext *tc, MVMCompUnit *cu) {
     }
     rs->string_seg       = cu_body->data_start + offset;
     rs->expected_strings = read_int32(cu_body->data_start, STRING_HEADER_OFFSET + 4);
+    if (version >= 8 && (MVMuint64)offset + (MVMuint64)rs->expected_strings * 4 > cu_body->data_size) {
+        cleanup_all(rs);
+        MVM_exception_throw_adhoc(tc, "Strings index overflows end of stream");
+    }
 
     /* Get SC data, if any. */
     offset = read_int32(cu_body->data_start, SCDATA_HEADER_OFFSET);
@@ -464,111 +464,77 @@ static MVMExtOpRecord * deserialize_extop_records(MVMThreadContext *tc, MVMCompU
     return extops;
 }
 
-/* Loads the static frame information (what locals we have, bytecode offset,
- * lexicals, etc.) and returns a list of them. */
-static MVMStaticFrame ** deserialize_frames(MVMThreadContext *tc, MVMCompUnit *cu, ReaderState *rs) {
-    MVMStaticFrame **frames;
+/* Scans the static frame records, checking what is needed to later create
+ * the frames from them, and noting where each one starts. Frames and their
+ * code objects are only created on first use, by MVM_cu_coderef, as large
+ * compilation units contain many frames that are never used. */
+static void scan_frames(MVMThreadContext *tc, MVMCompUnit *cu, ReaderState *rs) {
+    MVMCompUnitBody *cu_body = &cu->body;
     MVMuint8        *pos;
+    MVMuint8        *state;
     MVMuint32        bytecode_pos, bytecode_size, i, j;
     MVMuint16        bytecode_version = rs->version;
 
-    /* Allocate frames array. */
     if (rs->expected_frames == 0) {
         cleanup_all(rs);
         MVM_exception_throw_adhoc(tc, "Bytecode file must have at least one frame");
     }
-    frames = MVM_malloc(sizeof(MVMStaticFrame *) * rs->expected_frames);
+    cu_body->frame_offsets = MVM_malloc(sizeof(MVMuint32) * rs->expected_frames);
+    cu_body->bytecode_seg   = rs->bytecode_seg;
+    cu_body->annotation_seg = rs->annotation_seg;
 
     /* Allocate outer fixup list for frames. */
     rs->frame_outer_fixups = MVM_malloc(sizeof(MVMuint16) * rs->expected_frames);
 
-    /* Load frames. */
+    /* Scan frames. */
     pos = rs->frame_seg;
     for (i = 0; i < rs->expected_frames; i++) {
-        MVMStaticFrame *static_frame;
-        MVMStaticFrameBody *static_frame_body;
-
         /* Ensure we can read a frame here. */
         ensure_can_read(tc, cu, rs, pos, FRAME_HEADER_SIZE);
+        cu_body->frame_offsets[i] = (MVMuint32)(pos - cu_body->data_start);
 
-        /* Allocate frame and get/check bytecode start/length. */
-        static_frame = (MVMStaticFrame *)MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTStaticFrame);
-        MVM_ASSIGN_REF(tc, &(cu->common.header), frames[i], static_frame);
-        static_frame_body = &static_frame->body;
+        /* Check bytecode start/length. */
         bytecode_pos = read_int32(pos, 0);
         bytecode_size = read_int32(pos, 4);
         if (bytecode_pos >= rs->bytecode_size) {
             MVMuint32 bytecode_size = rs->bytecode_size;
             cleanup_all(rs);
-            MVM_free(frames);
             MVM_exception_throw_adhoc(tc, "Frame has invalid bytecode start point %d (size %d)", bytecode_pos, bytecode_size);
         }
         if (bytecode_pos + bytecode_size > rs->bytecode_size) {
             cleanup_all(rs);
-            MVM_free(frames);
             MVM_exception_throw_adhoc(tc, "Frame bytecode overflows bytecode stream");
         }
-        static_frame_body->bytecode      = rs->bytecode_seg + bytecode_pos;
-        static_frame_body->bytecode_size = bytecode_size;
-        static_frame_body->orig_bytecode = static_frame_body->bytecode;
-
-        /* Get number of locals and lexicals. */
-        static_frame_body->num_locals   = read_int32(pos, 8);
-        static_frame_body->num_lexicals = read_int32(pos, 12);
 
-        /* Get compilation unit unique ID and name. */
-        MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->cuuid, get_heap_string(tc, cu, rs, pos, 16));
-        MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->name, get_heap_string(tc, cu, rs, pos, 20));
+        /* Check compilation unit unique ID and name. */
+        if (read_int32(pos, 16) >= cu_body->num_strings || read_int32(pos, 20) >= cu_body->num_strings) {
+            cleanup_all(rs);
+            MVM_exception_throw_adhoc(tc, "String heap index beyond end of string heap");
+        }
 
         /* Add frame outer fixup to fixup list. */
         rs->frame_outer_fixups[i] = read_int16(pos, 24);
 
-        /* Get annotations details */
+        /* Check annotations details */
         {
             MVMuint32 annot_offset    = read_int32(pos, 26);
             MVMuint32 num_annotations = read_int32(pos, 30);
             if (annot_offset + num_annotations * 12 > rs->annotation_size) {
                 cleanup_all(rs);
-                MVM_free(frames);
                 MVM_exception_throw_adhoc(tc, "Frame annotation segment overflows bytecode stream");
             }
-            static_frame_body->annotations_data = rs->annotation_seg + annot_offset;
-            static_frame_body->num_annotations  = num_annotations;
-        }
-
-        /* Read number of handlers. */
-        static_frame_body->num_handlers = read_int32(pos, 34);
-
-        /* Read exit handler flag (version 2 and higher). */
-        if (rs->version >= 2) {
-            MVMint16 flags = read_int16(pos, 38);
-            static_frame_body->has_exit_handler = flags & FRAME_FLAG_EXIT_HANDLER;
-            static_frame_body->is_thunk         = flags & FRAME_FLAG_IS_THUNK;
-            static_frame_body->no_inline        = flags & FRAME_FLAG_NO_INLINE;
         }
 
-        /* Read code object SC indexes (version 4 and higher). */
-        if (rs->version >= 4) {
-            static_frame_body->code_obj_sc_dep_idx = read_int32(pos, 42);
-            static_frame_body->code_obj_sc_idx     = read_int32(pos, 46);
-        }
-
-        /* Associate frame with compilation unit. */
-        MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->cu, cu);
-
-        /* Stash position for lazy deserialization of the rest. */
-        static_frame_body->frame_data_pos = pos;
-
         /* Skip over the rest, making sure it's readable. */
         {
-            MVMuint32 skip = 2 * static_frame_body->num_locals +
-                             6 * static_frame_body->num_lexicals;
+            MVMuint32 skip = 2 * read_int32(pos, 8) + 6 * read_int32(pos, 12);
+            MVMuint32 num_handlers = read_int32(pos, 34);
             MVMuint16 slvs = read_int16(pos, 40);
             MVMuint32 num_local_debug_names = rs->version >= 6 ? read_int32(pos, 50) : 0;
             pos += FRAME_HEADER_SIZE;
             ensure_can_read(tc, cu, rs, pos, skip);
             pos += skip;
-            for (j = 0; j < static_frame_body->num_handlers; j++) {
+            for (j = 0; j < num_handlers; j++) {
                 ensure_can_read(tc, cu, rs, pos, FRAME_HANDLER_SIZE);
                 if (read_int32(pos, 8) & MVM_EX_CAT_LABELED) {
                     pos += FRAME_HANDLER_SIZE;
@@ -586,21 +552,134 @@ static MVMStaticFrame ** deserialize_frames(MVMThreadContext *tc, MVMCompUnit *c
         }
     }
 
-    /* Fixup outers. */
+    /* Check outers. Since a frame's outer is created before it, they must
+     * not form a cycle; frames on the chain being followed are in state 1,
+     * and those already known to lead to a frame without an outer in 2. */
+    state = MVM_calloc(rs->expected_frames, 1);
     for (i = 0; i < rs->expected_frames; i++) {
-        if (rs->frame_outer_fixups[i] != i) {
-            if (rs->frame_outer_fixups[i] < rs->expected_frames) {
-                MVM_ASSIGN_REF(tc, &(frames[i]->common.header), frames[i]->body.outer, frames[rs->frame_outer_fixups[i]]);
-            }
-            else {
+        for (j = i; state[j] == 0; j = rs->frame_outer_fixups[j]) {
+            if (rs->frame_outer_fixups[j] != j && rs->frame_outer_fixups[j] >= rs->expected_frames) {
+                MVM_free(state);
                 cleanup_all(rs);
-                MVM_free(frames);
                 MVM_exception_throw_adhoc(tc, "Invalid frame outer index; cannot fixup");
             }
+            state[j] = 1;
+            if (rs->frame_outer_fixups[j] == j)
+                break;
         }
+        if (state[j] == 1 && rs->frame_outer_fixups[j] != j) {
+            MVM_free(state);
+            cleanup_all(rs);
+            MVM_exception_throw_adhoc(tc, "Frame outers form a cycle");
+        }
+        for (j = i; state[j] == 1; j = rs->frame_outer_fixups[j]) {
+            state[j] = 2;
+            if (rs->frame_outer_fixups[j] == j)
+                break;
+        }
+    }
+    MVM_free(state);
+}
+
+/* Creates the static frame and code object of a frame from its record, on
+ * first use, along with those of its outers. */
+MVMObject * MVM_bytecode_materialize_frame(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint32 idx) {
+    MVMStaticFrame     *static_frame;
+    MVMStaticFrameBody *static_frame_body;
+    MVMCode            *coderef;
+    MVMObject          *outer_code;
+    MVMString          *cuuid = NULL;
+    MVMString          *name  = NULL;
+    MVMuint8           *pos;
+    MVMuint16           outer_idx;
+
+    /* Do everything that may throw before taking the mutex and entering
+     * gen2 allocation, as neither would be released if it did. Create the
+     * outer first; scan_frames made sure this terminates. */
+    pos       = cu->body.data_start + cu->body.frame_offsets[idx];
+    outer_idx = read_int16(pos, 24);
+    MVMROOT(tc, cu, {
+        outer_code = outer_idx != idx ? MVM_cu_coderef(tc, cu, outer_idx) : NULL;
+    });
+
+    /* Get compilation unit unique ID and name, then acquire the update mutex
+     * on the CompUnit, and make sure no other thread created the frame in
+     * the mean time. */
+    MVMROOT4(tc, cu, outer_code, cuuid, name, {
+        cuuid = get_heap_string(tc, cu, NULL, pos, 16);
+        name  = get_heap_string(tc, cu, NULL, pos, 20);
+        MVM_reentrantmutex_lock(tc, (MVMReentrantMutex *)cu->body.deserialize_frame_mutex);
+    });
+    if (cu->body.coderefs[idx]) {
+        MVM_reentrantmutex_unlock(tc, (MVMReentrantMutex *)cu->body.deserialize_frame_mutex);
+        return cu->body.coderefs[idx];
     }
 
-    return frames;
+    /* Allocate directly in generation 2 so nothing moves around. */
+    MVM_gc_allocate_gen2_default_set(tc);
+
+    /* Allocate frame and set up bytecode start/length. */
+    static_frame = (MVMStaticFrame *)MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTStaticFrame);
+    static_frame_body = &static_frame->body;
+    static_frame_body->bytecode      = cu->body.bytecode_seg + read_int32(pos, 0);
+    static_frame_body->bytecode_size = read_int32(pos, 4);
+    static_frame_body->orig_bytecode = static_frame_body->bytecode;
+
+    /* Get number of locals and lexicals. */
+    static_frame_body->num_locals   = read_int32(pos, 8);
+    static_frame_body->num_lexicals = read_int32(pos, 12);
+
+    /* Set compilation unit unique ID and name. */
+    MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->cuuid, cuuid);
+    MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->name, name);
+
+    /* Set outer. */
+    if (outer_code)
+        MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->outer,
+            ((MVMCode *)outer_code)->body.sf);
+
+    /* Get annotations details */
+    static_frame_body->annotations_data = cu->body.annotation_seg + read_int32(pos, 26);
+    static_frame_body->num_annotations  = read_int32(pos, 30);
+
+    /* Read number of handlers. */
+    static_frame_body->num_handlers = read_int32(pos, 34);
+
+    /* Read exit handler flag (version 2 and higher). */
+    if (cu->body.bytecode_version >= 2) {
+        MVMint16 flags = read_int16(pos, 38);
+        static_frame_body->has_exit_handler = flags & FRAME_FLAG_EXIT_HANDLER;
+        static_frame_body->is_thunk         = flags & FRAME_FLAG_IS_THUNK;
+        static_frame_body->no_inline        = flags & FRAME_FLAG_NO_INLINE;
+    }
+
+    /* Read code object SC indexes (version 4 and higher). */
+    if (cu->body.bytecode_version >= 4) {
+        static_frame_body->code_obj_sc_dep_idx = read_int32(pos, 42);
+        static_frame_body->code_obj_sc_idx     = read_int32(pos, 46);
+    }
+
+    /* Associate frame with compilation unit. */
+    MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->cu, cu);
+
+    /* Stash position for lazy deserialization of the rest. */
+    static_frame_body->frame_data_pos = pos;
+
+    /* Give it a code object. */
+    coderef = (MVMCode *)REPR(tc->instance->boot_types.BOOTCode)->allocate(tc,
+        STABLE(tc->instance->boot_types.BOOTCode));
+    MVM_ASSIGN_REF(tc, &(coderef->common.header), coderef->body.sf, static_frame);
+    MVM_ASSIGN_REF(tc, &(coderef->common.header), coderef->body.name, static_frame_body->name);
+    MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->static_code, coderef);
+
+    /* Publish it only once it is complete, as it is looked for without
+     * holding the mutex. */
+    MVM_barrier();
+    MVM_ASSIGN_REF(tc, &(cu->common.header), cu->body.coderefs[idx], (MVMObject *)coderef);
+
+    MVM_gc_allocate_gen2_default_clear(tc);
+    MVM_reentrantmutex_unlock(tc, (MVMReentrantMutex *)cu->body.deserialize_frame_mutex);
+    return (MVMObject *)coderef;
 }
 
 /* Finishes up reading and exploding of a frame. */
@@ -968,22 +1047,9 @@ static MVMCallsite ** deserialize_callsites(MVMThreadContext *tc, MVMCompUnit *c
     return callsites;
 }
 
-/* Creates code objects to go with each of the static frames. */
-static void create_code_objects(MVMThreadContext *tc, MVMCompUnit *cu, ReaderState *rs) {
-    MVMuint32  i;
-    MVMObject *code_type;
-    MVMCompUnitBody *cu_body = &cu->body;
-
-    cu_body->coderefs = MVM_malloc(cu_body->num_frames * sizeof(MVMObject *));
-
-    code_type = tc->instance->boot_types.BOOTCode;
-    for (i = 0; i < cu_body->num_frames; i++) {
-        MVMCode *coderef = (MVMCode *)REPR(code_type)->allocate(tc, STABLE(code_type));
-        MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->coderefs[i], coderef);
-        MVM_ASSIGN_REF(tc, &(coderef->common.header), coderef->body.sf, rs->frames[i]);
-        MVM_ASSIGN_REF(tc, &(coderef->common.header), coderef->body.name, rs->frames[i]->body.name);
-        MVM_ASSIGN_REF(tc, &(rs->frames[i]->common.header), rs->frames[i]->body.static_code, coderef);
-    }
+/* Gets one of the frames the compilation unit refers to directly. */
+static MVMStaticFrame * special_frame(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint32 idx) {
+    return ((MVMCode *)MVM_cu_coderef(tc, cu, idx))->body.sf;
 }
 
 /* Takes a compilation unit pointing at a bytecode stream (which actually
@@ -1003,10 +1069,17 @@ void MVM_bytecode_unpack(MVMThreadContext *tc, MVMCompUnit *cu) {
         rs->expected_strings * sizeof(MVMString *));
     cu_body->num_strings = rs->expected_strings;
     cu_body->orig_strings = rs->expected_strings;
-    cu_body->string_heap_fast_table = MVM_calloc(
-        (rs->expected_strings / MVM_STRING_FAST_TABLE_SPAN) + 1,
-        sizeof(MVMuint32));
-    cu_body->string_heap_start = rs->string_seg;
+    if (rs->version >= 8) {
+        /* Strings can be found directly through the index. */
+        cu_body->string_heap_index = rs->string_seg;
+        cu_body->string_heap_start = rs->string_seg + rs->expected_strings * 4;
+    }
+    else {
+        cu_body->string_heap_fast_table = MVM_calloc(
+            (rs->expected_strings / MVM_STRING_FAST_TABLE_SPAN) + 1,
+            sizeof(MVMuint32));
+        cu_body->string_heap_start = rs->string_seg;
+    }
     cu_body->string_heap_read_limit = rs->read_limit;
 
     /* Load SC dependencies. */
@@ -1016,11 +1089,11 @@ void MVM_bytecode_unpack(MVMThreadContext *tc, MVMCompUnit *cu) {
     cu_body->extops = deserialize_extop_records(tc, cu, rs);
     cu_body->num_extops = rs->expected_extops;
 
-    /* Load the static frame info and give each one a code reference. */
-    rs->frames = deserialize_frames(tc, cu, rs);
+    /* Scan the static frame info; frames are created on first use. */
+    scan_frames(tc, cu, rs);
+    cu_body->coderefs = MVM_calloc(rs->expected_frames, sizeof(MVMObject *));
     cu_body->num_frames = rs->expected_frames;
     cu_body->orig_frames = rs->expected_frames;
-    create_code_objects(tc, cu, rs);
 
     /* Load callsites. */
     cu_body->max_callsite_size = MVM_MIN_CALLSITE_SIZE;
@@ -1041,13 +1114,15 @@ void MVM_bytecode_unpack(MVMThreadContext *tc, MVMCompUnit *cu) {
     /* Resolve special frames. */
     if (rs->mainline_frame)
         MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->mainline_frame,
-            rs->mainline_frame ? rs->frames[rs->mainline_frame - 1] : rs->frames[0]);
+            special_frame(tc, cu, rs->mainline_frame - 1));
     MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->main_frame,
-        rs->main_frame ? rs->frames[rs->main_frame - 1] : rs->frames[0]);
+        special_frame(tc, cu, rs->main_frame ? rs->main_frame - 1 : 0));
     if (rs->load_frame)
-        MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->load_frame, rs->frames[rs->load_frame - 1]);
+        MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->load_frame,
+            special_frame(tc, cu, rs->load_frame - 1));
     if (rs->deserialize_frame)
-        MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->deserialize_frame, rs->frames[rs->deserialize_frame - 1]);
+        MVM_ASSIGN_REF(tc, &(cu->common.header), cu_body->deserialize_frame,
+            special_frame(tc, cu, rs->deserialize_frame - 1));
 
     /* Clean up reader state. */
     cleanup_all(rs);
@@ -1056,21 +1131,26 @@ void MVM_bytecode_unpack(MVMThreadContext *tc, MVMCompUnit *cu) {
     MVM_gc_allocate_gen2_default_clear(tc);
 }
 
-/* returns the annotation for that bytecode offset */
+/* returns the annotation for that bytecode offset. Annotations are written
+ * in order of bytecode offset, and are fixed size, so we binary search for
+ * the first one past the offset, and then take the one before it. */
 MVMBytecodeAnnotation * MVM_bytecode_resolve_annotation(MVMThreadContext *tc, MVMStaticFrameBody *sfb, MVMuint32 offset) {
     MVMBytecodeAnnotation *ba = NULL;
     MVMuint32 i;
 
     if (sfb->num_annotations && offset < sfb->bytecode_size) {
-        MVMuint8 *cur_anno = sfb->annotations_data;
-        for (i = 0; i < sfb->num_annotations; i++) {
-            MVMuint32 ann_offset = read_int32(cur_anno, 0);
-            if (ann_offset > offset)
-                break;
-            cur_anno += 12;
+        MVMuint8 *cur_anno;
+        MVMuint32 lo = 0;
+        MVMuint32 hi = sfb->num_annotations;
+        while (lo < hi) {
+            MVMuint32 mid = lo + (hi - lo) / 2;
+            if (read_int32(sfb->annotations_data, mid * 12) > offset)
+                hi = mid;
+            else
+                lo = mid + 1;
         }
-        if (i)
-            cur_anno -= 12;
+        i = lo;
+        cur_anno = sfb->annotations_data + (i ? i - 1 : 0) * 12;
         ba = MVM_malloc(sizeof(MVMBytecodeAnnotation));
         ba->bytecode_offset = read_int32(cur_anno, 0);
         ba->filename_string_heap_index = read_int32(cur_anno, 4);
@@ -59,7 +59,7 @@ enum {
 };
 
 static MVMStaticFrame * get_frame(MVMThreadContext *tc, MVMCompUnit *cu, int idx) {
-    return ((MVMCode *)cu->body.coderefs[idx])->body.sf;
+    return ((MVMCode *)MVM_cu_coderef(tc, cu, idx))->body.sf;
 }
 
 static void bytecode_dump_frame_internal(MVMThreadContext *tc, MVMStaticFrame *frame, MVMSpeshCandidate *maybe_candidate, MVMuint8 *frame_cur_op, char ***frame_lexicals, char **oo, MVMuint32 *os, MVMuint32 *ol) {
@@ -128,6 +128,8 @@ static void bytecode_dump_frame_internal(MVMThreadContext *tc, MVMStaticFrame *f
         }
 
         op_num = *((MVMint16 *)cur_op);
+        if (op_num == MVM_OP_sp_predecoded && !maybe_candidate)
+            op_num = MVM_predecode_orig_op(tc, static_frame, lineloc);
         cur_op += 2;
         if (op_num < MVM_OP_EXT_BASE) {
             op_info = MVM_op_get_op(op_num);
@@ -25,6 +25,14 @@ MVMCompUnit * MVM_cu_from_bytes(MVMThreadContext *tc, MVMuint8 *bytes, MVMuint32
     cu->body.hll_config = MVM_hll_get_config_for(tc, cu->body.hll_name);
     MVM_gc_write_barrier_hit(tc, (MVMCollectable *)cu);
 
+    /* Being born in gen2, the compilation unit is never counted as promoted,
+     * yet it holds the bytecode and more outside of the managed heap, which
+     * only a full collection frees. Count that towards one here, so loading
+     * many compilation units (say, from EVAL) leads to full collections that
+     * unload those no longer reachable. */
+    MVM_add(&tc->instance->gc_promoted_bytes_since_last_full,
+        size + REPR(cu)->unmanaged_size(tc, STABLE(cu), OBJECT_BODY(cu)));
+
     return cu;
 }
 
@@ -62,6 +70,7 @@ MVMCompUnit * MVM_cu_map_from_file(MVMThreadContext *tc, const char *filename) {
     cu = MVM_cu_from_bytes(tc, (MVMuint8 *)block, (MVMuint32)size);
     cu->body.handle = handle;
     cu->body.deallocate = MVM_DEALLOCATE_UNMAP;
+    MVM_validation_cache_load(tc, cu, &(req.statbuf), 0);
     return cu;
 }
 
@@ -91,6 +100,7 @@ MVMCompUnit * MVM_cu_map_from_file_handle(MVMThreadContext *tc, uv_file fd, MVMu
     cu = MVM_cu_from_bytes(tc, (MVMuint8 *)block, (MVMuint32)size);
     cu->body.handle = handle;
     cu->body.deallocate = MVM_DEALLOCATE_UNMAP;
+    MVM_validation_cache_load(tc, cu, &(req.statbuf), pos);
     return cu;
 }
 
@@ -199,43 +209,88 @@ static void compute_fast_table_upto(MVMThreadContext *tc, MVMCompUnit *cu, MVMui
     cu->body.string_heap_fast_table_top = end_bin;
 }
 MVMString * MVM_cu_obtain_string(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint32 idx) {
-    MVMuint32  cur_idx;
     MVMuint8  *cur_pos;
     MVMuint8  *limit = cu->body.string_heap_read_limit;
+    MVMuint32  encoding;
 
-    /* Make sure we've enough entries in the fast table to jump close to where
-     * the string will be. */
-    MVMuint32 fast_bin = idx / MVM_STRING_FAST_TABLE_SPAN;
-    if (fast_bin > cu->body.string_heap_fast_table_top)
-        compute_fast_table_upto(tc, cu, fast_bin);
-
-    /* Scan from that position to find the string we need. */
-    cur_idx = fast_bin * MVM_STRING_FAST_TABLE_SPAN;
-    cur_pos = cu->body.string_heap_start + cu->body.string_heap_fast_table[fast_bin];
-    while (cur_idx != idx) {
-        if (cur_pos + 4 < limit) {
-            MVMuint32 bytes = read_uint32(cur_pos) >> 1;
-            cur_pos += 4 + bytes + (bytes & 3 ? 4 - (bytes & 3) : 0);
-        }
-        else {
-            MVM_exception_throw_adhoc(tc,
-                "Attempt to read past end of string heap when locating string");
+    if (cu->body.string_heap_index) {
+        /* Look the string up in the index. */
+        cur_pos = cu->body.string_heap_start + read_uint32(cu->body.string_heap_index + 4 * idx);
+    }
+    else {
+        /* Make sure we've enough entries in the fast table to jump close to
+         * where the string will be. */
+        MVMuint32 fast_bin = idx / MVM_STRING_FAST_TABLE_SPAN;
+        MVMuint32 cur_idx;
+        if (fast_bin > cu->body.string_heap_fast_table_top)
+            compute_fast_table_upto(tc, cu, fast_bin);
+
+        /* Scan from that position to find the string we need. */
+        cur_idx = fast_bin * MVM_STRING_FAST_TABLE_SPAN;
+        cur_pos = cu->body.string_heap_start + cu->body.string_heap_fast_table[fast_bin];
+        while (cur_idx != idx) {
+            if (cur_pos + 4 < limit) {
+                MVMuint32 bytes = read_uint32(cur_pos) >> 1;
+                cur_pos += 4 + bytes + (bytes & 3 ? 4 - (bytes & 3) : 0);
+            }
+            else {
+                MVM_exception_throw_adhoc(tc,
+                    "Attempt to read past end of string heap when locating string");
+            }
+            cur_idx++;
         }
-        cur_idx++;
     }
 
-    /* Read the string. */
+    /* Read the string. Before version 8 the low bit of the length word says
+     * whether it is UTF-8 or latin-1; from version 8 on, the low two bits
+     * give the encoding, which may also be ASCII without any \r\n, needing
+     * no decoding at all. */
     if (cur_pos + 4 < limit) {
         MVMuint32 ss = read_uint32(cur_pos);
-        MVMuint32 bytes = ss >> 1;
-        MVMuint32 decode_utf8 = ss & 1;
+        MVMuint32 bytes;
+        if (cu->body.string_heap_index) {
+            bytes    = ss >> 2;
+            encoding = ss & 3;
+        }
+        else {
+            bytes    = ss >> 1;
+            encoding = ss & 1;
+        }
         cur_pos += 4;
         if (cur_pos + bytes < limit) {
             MVMString *s;
             MVM_gc_allocate_gen2_default_set(tc);
-            s = decode_utf8
-                ? MVM_string_utf8_decode(tc, tc->instance->VMString, (char *)cur_pos, bytes)
-                : MVM_string_latin1_decode(tc, tc->instance->VMString, (char *)cur_pos, bytes);
+            switch (encoding) {
+                case MVM_CU_STRING_UTF8:
+                    s = MVM_string_utf8_decode(tc, tc->instance->VMString, (char *)cur_pos, bytes);
+                    break;
+                case MVM_CU_STRING_ASCII: {
+                    /* The heap may not be trusted to be what it says, so
+                     * anything that isn't plain ASCII without \r\n goes
+                     * through the UTF-8 decoder instead, which normalizes
+                     * it or throws. */
+                    MVMGrapheme8 *buf;
+                    MVMuint32 i;
+                    for (i = 0; i < bytes; i++)
+                        if (cur_pos[i] >= 0x80 || (cur_pos[i] == '\r' && i + 1 < bytes && cur_pos[i + 1] == '\n'))
+                            break;
+                    if (i != bytes) {
+                        s = MVM_string_utf8_decode(tc, tc->instance->VMString, (char *)cur_pos, bytes);
+                        break;
+                    }
+                    buf = MVM_malloc(bytes ? bytes : 1);
+                    memcpy(buf, cur_pos, bytes);
+                    s = MVM_string_ascii_from_buf_nocheck(tc, buf, bytes);
+                    break;
+                }
+                case MVM_CU_STRING_LATIN1:
+                    s = MVM_string_latin1_decode(tc, tc->instance->VMString, (char *)cur_pos, bytes);
+                    break;
+                default:
+                    MVM_gc_allocate_gen2_default_clear(tc);
+                    MVM_exception_throw_adhoc(tc,
+                        "Unknown string heap encoding %u", encoding);
+            }
             MVM_ASSIGN_REF(tc, &(cu->common.header), cu->body.strings[idx], s);
             MVM_gc_allocate_gen2_default_clear(tc);
             return s;
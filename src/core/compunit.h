@@ -1,3 +1,9 @@
+/* How a string in the string heap is encoded. ASCII only appears from
+ * bytecode version 8 on. */
+#define MVM_CU_STRING_LATIN1 0
+#define MVM_CU_STRING_UTF8   1
+#define MVM_CU_STRING_ASCII  2
+
 MVMCompUnit * MVM_cu_from_bytes(MVMThreadContext *tc, MVMuint8 *bytes, MVMuint32 size);
 MVMCompUnit * MVM_cu_map_from_file(MVMThreadContext *tc, const char *filename);
 MVMCompUnit * MVM_cu_map_from_file_handle(MVMThreadContext *tc, uv_file fd, MVMuint64 pos);
@@ -10,6 +16,13 @@ MVM_STATIC_INLINE MVMString * MVM_cu_string(MVMThreadContext *tc, MVMCompUnit *c
     return s ? s : MVM_cu_obtain_string(tc, cu, idx);
 }
 
+/* Gets the code object of a frame, creating it and the static frame on
+ * first use. */
+MVM_STATIC_INLINE MVMObject * MVM_cu_coderef(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint32 idx) {
+    MVMObject *code = cu->body.coderefs[idx];
+    return code ? code : MVM_bytecode_materialize_frame(tc, cu, idx);
+}
+
 MVM_STATIC_INLINE void MVM_cu_ensure_string_decoded(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint32 idx) {
     if (!cu->body.strings[idx])
         MVM_cu_obtain_string(tc, cu, idx);
@@ -57,6 +57,10 @@ static void prepare_and_verify_static_frame(MVMThreadContext *tc, MVMStaticFrame
             MVM_validate_static_frame(tc, static_frame);
         });
 
+        /* Pre-decode hot runs of simple ops, now we know they are valid. */
+        if (tc->instance->predecode_enabled)
+            MVM_predecode_static_frame(tc, static_frame);
+
         /* Compute work area initial state that we can memcpy into place each
          * time. */
         if (static_frame_body->num_locals)
@@ -84,6 +88,10 @@ static void prepare_and_verify_static_frame(MVMThreadContext *tc, MVMStaticFrame
         MVM_ASSIGN_REF(tc, &(static_frame->common.header), static_frame_body->spesh, /* no GC error */
             MVM_repr_alloc_init(tc, tc->instance->StaticFrameSpesh));
         MVM_gc_allocate_gen2_default_clear(tc);
+        if (static_frame_body->inline_cache_shift)
+            MVM_inline_cache_init(tc, &(static_frame_body->spesh->body.inline_cache),
+                static_frame_body->bytecode, static_frame_body->bytecode_size,
+                static_frame_body->inline_cache_shift);
 
         /* We now have at least instrumentation level 1. */
         static_frame->body.instrumentation_level = 1;
@@ -227,7 +235,7 @@ static MVMFrame * autoclose(MVMThreadContext *tc, MVMStaticFrame *needed) {
     /* First, see if we can find one on the call stack; return it if so. */
     MVMFrame *candidate = tc->cur_frame;
     while (candidate) {
-        if (candidate->static_info->body.bytecode == needed->body.bytecode)
+        if (candidate->static_info->body.orig_bytecode == needed->body.orig_bytecode)
             return candidate;
         candidate = candidate->caller;
     }
@@ -240,7 +248,7 @@ static MVMFrame * autoclose(MVMThreadContext *tc, MVMStaticFrame *needed) {
         /* See if the static code object has an outer. */
         MVMCode *outer_code = needed->body.outer->body.static_code;
         if (outer_code->body.outer &&
-                outer_code->body.outer->static_info->body.bytecode == needed->body.bytecode) {
+                outer_code->body.outer->static_info->body.orig_bytecode == needed->body.orig_bytecode) {
             /* Yes, just take it. */
             MVM_ASSIGN_REF(tc, &(result->header), result->outer, outer_code->body.outer);
         }
@@ -487,9 +495,12 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
         }
     }
 
-    /* See if any specializations apply. */
+    /* See if any specializations apply. Frames too big to specialize as a
+     * whole only have loop region candidates, which are entered by OSR. */
     spesh = static_frame->body.spesh;
-    if (spesh_cand < 0)
+    if (spesh_cand >= 0 && spesh->body.spesh_candidates[spesh_cand]->eviction_state)
+        spesh_cand = -1;
+    if (spesh_cand < 0 && static_frame->body.bytecode_size <= MVM_SPESH_MAX_BYTECODE_SIZE)
         spesh_cand = MVM_spesh_arg_guard_run(tc, spesh->body.spesh_arg_guard,
             callsite, args, NULL);
 #if MVM_SPESH_CHECK_PRESELECTION
@@ -508,6 +519,7 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
 #endif
     if (spesh_cand >= 0) {
         MVMSpeshCandidate *chosen_cand = spesh->body.spesh_candidates[spesh_cand];
+        chosen_cand->usage_count++;
         if (static_frame->body.allocate_on_heap) {
             MVMROOT3(tc, static_frame, code_ref, outer, {
                 frame = allocate_frame(tc, static_frame, chosen_cand, 1);
@@ -543,7 +555,7 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
         chosen_bytecode = static_frame->body.bytecode;
 
         /* If we should be spesh logging, set the correlation ID. */
-        if (tc->instance->spesh_enabled && tc->spesh_log && static_frame->body.bytecode_size < MVM_SPESH_MAX_BYTECODE_SIZE) {
+        if (tc->instance->spesh_enabled && tc->spesh_log && static_frame->body.bytecode_size < MVM_SPESH_MAX_REGION_BYTECODE_SIZE) {
             if (spesh->body.spesh_entries_recorded++ < MVM_SPESH_LOG_LOGGED_ENOUGH) {
                 MVMint32 id = ++tc->spesh_cid;
                 frame->spesh_correlation_id = id;
@@ -1054,6 +1066,61 @@ MVMuint64 MVM_frame_try_return_no_exit_handlers(MVMThreadContext *tc) {
     return remove_one_frame(tc, 0);
 }
 
+/* Invokes the specified code object from tail position in the current frame.
+ * Provided nothing can observe the current frame once it would return, it is
+ * removed first and the invokee takes its place, returning straight to our
+ * caller. The arguments are moved into the caller's argument buffer, which we
+ * no longer need, so the invokee can still read them. If the current frame
+ * can't be replaced, this is just a normal invoke. */
+void MVM_frame_tail_invoke(MVMThreadContext *tc, MVMObject *code,
+                           MVMCallsite *callsite, MVMRegister *args) {
+    MVMFrame *returner = tc->cur_frame;
+    MVMFrame *caller   = returner->caller;
+    if (REPR(code)->ID == MVM_REPR_ID_MVMCode && IS_CONCRETE(code) &&
+            caller && caller->work && returner != tc->thread_entry_frame &&
+            !returner->extra && !returner->static_info->body.has_exit_handler &&
+            callsite->arg_count <= caller->static_info->body.cu->body.max_callsite_size &&
+            !tc->instance->profiling && !tc->instance->debugserver) {
+        MVMCode *invokee = (MVMCode *)code;
+
+        /* If we're in JIT-compiled code, it should leave once we're done. */
+        MVM_jit_code_trampoline(tc);
+
+        /* Move the arguments. */
+        memcpy(caller->args, args, callsite->arg_count * sizeof(MVMRegister));
+        caller->cur_args_callsite = callsite;
+
+        /* Remove the current frame, much as a return would, but without any
+         * switch back to the caller's code or special return handling. */
+        if (returner->work) {
+            MVM_args_proc_cleanup(tc, &returner->params);
+            MVM_fixed_size_free(tc, tc->instance->fsa, returner->allocd_work,
+                returner->work);
+        }
+        if (MVM_FRAME_IS_ON_CALLSTACK(tc, returner)) {
+            MVMCallStackRegion *stack = tc->stack_current;
+            stack->alloc = (char *)returner;
+            if ((char *)stack->alloc - sizeof(MVMCallStackRegion) == (char *)stack)
+                MVM_callstack_region_prev(tc);
+            if (returner->env)
+                MVM_fixed_size_free(tc, tc->instance->fsa, returner->allocd_env, returner->env);
+        }
+        else {
+            returner->work = NULL;
+            returner->caller = NULL;
+        }
+        tc->cur_frame = caller;
+        tc->current_frame_nr = caller->sequence_nr;
+
+        /* Invoke, which will take the place on the call stack we freed. */
+        MVM_frame_invoke(tc, invokee->body.sf, callsite, caller->args,
+            invokee->body.outer, code, -1);
+    }
+    else {
+        STABLE(code)->invoke(tc, code, callsite, args);
+    }
+}
+
 /* Unwinds execution state to the specified frame, placing control flow at either
  * an absolute or relative (to start of target frame) address and optionally
  * setting a returned result. */
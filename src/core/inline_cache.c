@@ -0,0 +1,199 @@
+#include "moar.h"
+
+/* Sets up the inline cache for a frame's bytecode, with one slot per
+ * (bytecode offset >> bit_shift). */
+void MVM_inline_cache_init(MVMThreadContext *tc, MVMInlineCache *cache,
+        MVMuint8 *bytecode, MVMuint32 bytecode_size, MVMuint8 bit_shift) {
+    cache->num_entries = (bytecode_size >> bit_shift) + 1;
+    cache->entries     = MVM_calloc(cache->num_entries, sizeof(MVMInlineCacheEntry *));
+    cache->bit_shift   = bit_shift;
+    cache->bytecode    = bytecode;
+}
+
+/* Finds the cache slot for the instruction at op, or NULL if the bytecode
+ * being run is not what the cache was laid out for. */
+static MVMInlineCacheEntry ** find_slot(MVMThreadContext *tc, MVMStaticFrameSpesh *spesh,
+        MVMuint8 *bytecode_start, MVMuint8 *op) {
+    MVMInlineCache *cache = &(spesh->body.inline_cache);
+    return cache->bytecode == bytecode_start
+        ? &(cache->entries[(op - bytecode_start) >> cache->bit_shift])
+        : NULL;
+}
+
+/* Tries to install a new entry in place of the one we missed on. If another
+ * thread got there first, we just drop ours. */
+static void install(MVMThreadContext *tc, MVMStaticFrameSpesh *spesh,
+        MVMInlineCacheEntry **slot, MVMInlineCacheEntry *prev, MVMuint32 misses,
+        MVMSTable *st, MVMObject *key, MVMObject *method, MVMuint32 offset) {
+    MVMInlineCacheEntry *entry = MVM_fixed_size_alloc(tc, tc->instance->fsa,
+        sizeof(MVMInlineCacheEntry));
+    entry->st     = st;
+    entry->key    = key;
+    entry->method = method;
+    entry->offset = offset;
+    entry->misses = misses;
+    if (MVM_trycas(slot, prev, entry)) {
+        MVM_gc_write_barrier(tc, (MVMCollectable *)spesh, (MVMCollectable *)st);
+        MVM_gc_write_barrier(tc, (MVMCollectable *)spesh, (MVMCollectable *)key);
+        MVM_gc_write_barrier(tc, (MVMCollectable *)spesh, (MVMCollectable *)method);
+        if (prev)
+            MVM_fixed_size_free_at_safepoint(tc, tc->instance->fsa,
+                sizeof(MVMInlineCacheEntry), prev);
+    }
+    else {
+        MVM_fixed_size_free(tc, tc->instance->fsa, sizeof(MVMInlineCacheEntry), entry);
+    }
+}
+
+/* Looks up a method for the findmeth instruction at op. A hit needs the
+ * type and its method cache to be the same as when the entry was made; a
+ * type that gains methods gets a new method cache, not an updated one. */
+void MVM_inline_cache_find_method(MVMThreadContext *tc, MVMuint8 *bytecode_start,
+        MVMuint8 *op, MVMObject *obj, MVMString *name, MVMRegister *res) {
+    MVMStaticFrameSpesh *spesh = tc->cur_frame->static_info->body.spesh;
+    MVMInlineCacheEntry **slot = find_slot(tc, spesh, bytecode_start, op);
+    MVMInlineCacheEntry *entry;
+    MVMuint32 misses;
+    MVMuint8 *prev_op;
+    MVMSTable *st;
+
+    if (!slot || MVM_is_null(tc, obj)) {
+        MVM_6model_find_method(tc, obj, name, res, 1);
+        return;
+    }
+
+    st = STABLE(obj);
+    entry = *slot;
+    if (entry) {
+        if (entry->st == st && entry->key == st->method_cache) {
+            res->o = entry->method;
+            return;
+        }
+        if (entry->misses >= MVM_INLINE_CACHE_MAX_MISSES) {
+            MVM_6model_find_method(tc, obj, name, res, 1);
+            return;
+        }
+        misses = entry->misses + 1;
+    }
+    else {
+        misses = 0;
+    }
+
+    /* Do the full lookup. If it had to call the meta-object's find_method,
+     * the result is not in yet, and we can't cache it. The lookup may GC,
+     * moving the object, its STable and the static frame's spesh data, so
+     * get them again afterwards. */
+    prev_op = *(tc->interp_cur_op);
+    MVMROOT(tc, obj, {
+        MVM_6model_find_method(tc, obj, name, res, 1);
+    });
+    if (*(tc->interp_cur_op) == prev_op) {
+        st = STABLE(obj);
+        if (st->method_cache && !MVM_is_null(tc, res->o))
+            install(tc, tc->cur_frame->static_info->body.spesh, slot, entry, misses,
+                st, st->method_cache, res->o, 0);
+    }
+}
+
+/* Reads an object attribute for the getattr_o instruction at op; the object
+ * must be concrete. Only directly stored attributes of P6opaque objects are
+ * cached. */
+void MVM_inline_cache_get_attribute(MVMThreadContext *tc, MVMuint8 *bytecode_start,
+        MVMuint8 *op, MVMObject *obj, MVMObject *class_handle, MVMString *name,
+        MVMint16 hint, MVMRegister *res) {
+    MVMStaticFrameSpesh *spesh = tc->cur_frame->static_info->body.spesh;
+    MVMInlineCacheEntry **slot = find_slot(tc, spesh, bytecode_start, op);
+    MVMInlineCacheEntry *entry;
+    MVMuint32 misses;
+    MVMSTable *st = STABLE(obj);
+    MVMint64 offset;
+
+    if (!slot || REPR(obj)->ID != MVM_REPR_ID_P6opaque) {
+        REPR(obj)->attr_funcs.get_attribute(tc, st, obj, OBJECT_BODY(obj),
+            class_handle, name, hint, res, MVM_reg_obj);
+        return;
+    }
+
+    entry = *slot;
+    if (entry) {
+        if (entry->st == st && entry->key == class_handle) {
+            /* A NULL attribute may want auto-vivifying, so leave that to the
+             * REPR. */
+            MVMObject *value = MVM_p6opaque_read_object(tc, obj, entry->offset);
+            if (value) {
+                res->o = value;
+                return;
+            }
+            REPR(obj)->attr_funcs.get_attribute(tc, st, obj, OBJECT_BODY(obj),
+                class_handle, name, hint, res, MVM_reg_obj);
+            return;
+        }
+        if (entry->misses >= MVM_INLINE_CACHE_MAX_MISSES) {
+            REPR(obj)->attr_funcs.get_attribute(tc, st, obj, OBJECT_BODY(obj),
+                class_handle, name, hint, res, MVM_reg_obj);
+            return;
+        }
+        misses = entry->misses + 1;
+    }
+    else {
+        misses = 0;
+    }
+
+    /* Auto-vivification may allocate, and so GC, moving the object, its
+     * STable and the static frame's spesh data; keep hold of what we need to
+     * make the entry and get the rest again afterwards. */
+    MVMROOT3(tc, obj, class_handle, name, {
+        REPR(obj)->attr_funcs.get_attribute(tc, st, obj, OBJECT_BODY(obj),
+            class_handle, name, hint, res, MVM_reg_obj);
+    });
+    st = STABLE(obj);
+    offset = MVM_p6opaque_get_obj_attr_offset(tc, st, class_handle, name, hint);
+    if (offset >= 0)
+        install(tc, tc->cur_frame->static_info->body.spesh, slot, entry, misses,
+            st, class_handle, NULL, (MVMuint32)offset);
+}
+
+/* Marks the objects referenced by the cache entries. */
+void MVM_inline_cache_gc_mark(MVMThreadContext *tc, MVMInlineCache *cache,
+        MVMGCWorklist *worklist) {
+    MVMuint32 i;
+    for (i = 0; i < cache->num_entries; i++) {
+        MVMInlineCacheEntry *entry = cache->entries[i];
+        if (entry) {
+            MVM_gc_worklist_add(tc, worklist, &(entry->st));
+            MVM_gc_worklist_add(tc, worklist, &(entry->key));
+            MVM_gc_worklist_add(tc, worklist, &(entry->method));
+        }
+    }
+}
+
+/* Describes the objects referenced by the cache entries for the heap
+ * snapshot. */
+void MVM_inline_cache_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *ss,
+        MVMInlineCache *cache) {
+    MVMuint32 i;
+    for (i = 0; i < cache->num_entries; i++) {
+        MVMInlineCacheEntry *entry = cache->entries[i];
+        if (entry) {
+            MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
+                (MVMCollectable *)entry->st, "Inline cache type");
+            MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
+                (MVMCollectable *)entry->key, "Inline cache key");
+            MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
+                (MVMCollectable *)entry->method, "Inline cache method");
+        }
+    }
+}
+
+/* Frees the cache entries and the slot table. */
+void MVM_inline_cache_destroy(MVMThreadContext *tc, MVMInlineCache *cache) {
+    MVMuint32 i;
+    for (i = 0; i < cache->num_entries; i++)
+        if (cache->entries[i])
+            MVM_fixed_size_free(tc, tc->instance->fsa, sizeof(MVMInlineCacheEntry),
+                cache->entries[i]);
+    MVM_free(cache->entries);
+    cache->entries     = NULL;
+    cache->num_entries = 0;
+    cache->bytecode    = NULL;
+}
@@ -0,0 +1,53 @@
+/* Monomorphic inline caches for method lookup (findmeth) and attribute access
+ * (getattr_o) in unspecialized bytecode. Each cacheable instruction gets a
+ * slot, found by shifting its bytecode offset right by an amount picked at
+ * validation time so that no two such instructions share one. */
+
+/* Number of times a site may miss and have its entry replaced before we stop
+ * caching there, considering it megamorphic. */
+#define MVM_INLINE_CACHE_MAX_MISSES 16
+
+/* A cache entry. Entries are immutable once installed; a miss installs a new
+ * one and frees the old one at the next safepoint. */
+struct MVMInlineCacheEntry {
+    /* The type of the object the lookup was done on. */
+    MVMSTable *st;
+
+    /* For findmeth, the method cache of the type at the time of the lookup;
+     * for getattr_o, the class handle. */
+    MVMObject *key;
+
+    /* For findmeth, the method that was found. */
+    MVMObject *method;
+
+    /* For getattr_o, the offset of the attribute in the P6opaque body. */
+    MVMuint32 offset;
+
+    /* Number of entries replaced at this site before this one. */
+    MVMuint32 misses;
+};
+
+/* The inline cache of a static frame, held in its spesh data. */
+struct MVMInlineCache {
+    /* Entries, indexed by bytecode offset shifted by bit_shift. */
+    MVMInlineCacheEntry **entries;
+    MVMuint32 num_entries;
+    MVMuint8 bit_shift;
+
+    /* The bytecode the entries are indexed for. Specialized and instrumented
+     * bytecode lay out their instructions differently and never match. */
+    MVMuint8 *bytecode;
+};
+
+void MVM_inline_cache_init(MVMThreadContext *tc, MVMInlineCache *cache,
+    MVMuint8 *bytecode, MVMuint32 bytecode_size, MVMuint8 bit_shift);
+void MVM_inline_cache_gc_mark(MVMThreadContext *tc, MVMInlineCache *cache,
+    MVMGCWorklist *worklist);
+void MVM_inline_cache_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *ss,
+    MVMInlineCache *cache);
+void MVM_inline_cache_destroy(MVMThreadContext *tc, MVMInlineCache *cache);
+void MVM_inline_cache_find_method(MVMThreadContext *tc, MVMuint8 *bytecode_start,
+    MVMuint8 *op, MVMObject *obj, MVMString *name, MVMRegister *res);
+void MVM_inline_cache_get_attribute(MVMThreadContext *tc, MVMuint8 *bytecode_start,
+    MVMuint8 *op, MVMObject *obj, MVMObject *class_handle, MVMString *name,
+    MVMint16 hint, MVMRegister *res);
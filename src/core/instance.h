@@ -30,6 +30,12 @@ typedef struct {
     MVMObject *RawDLLSym;
 } MVMRawTypes;
 
+/* A region of executable memory to be freed at the next safepoint. */
+typedef struct {
+    void   *memory;
+    size_t  size;
+} MVMJitFreeAtSafepoint;
+
 /* Various common string constants. */
 struct MVMStringConsts {
     MVMString *empty;
@@ -185,6 +191,9 @@ struct MVMInstance {
     /* Whether the current GC run is a full collection. */
     MVMuint32 gc_full_collect;
 
+    /* Number of full collections started so far. */
+    AO_t gc_full_seq_number;
+
     /* Are we in GC? Set by the coordinator at entry/exit of GC, and used by
      * native callback handling to decide if it should wait before trying to
      * lookup the current thread as the thread list may move under it. */
@@ -211,6 +220,10 @@ struct MVMInstance {
     MVM_VECTOR_DECL(void *, free_at_safepoint);
     uv_mutex_t mutex_free_at_safepoint;
 
+    /* Vector of JIT-compiled code to free at the next safepoint; also guarded
+     * by mutex_free_at_safepoint. */
+    MVM_VECTOR_DECL(MVMJitFreeAtSafepoint, jit_free_at_safepoint);
+
     /************************************************************************
      * Object system
      ************************************************************************/
@@ -269,14 +282,30 @@ struct MVMInstance {
     MVMint8 spesh_inline_log;
     MVMint8 spesh_osr_enabled;
     MVMint8 spesh_pea_enabled;
+    MVMint8 spesh_tailcall_enabled;
     MVMint8 spesh_nodelay;
     MVMint8 spesh_blocking;
 
+    /* Flag for if pre-decoding of unspecialized code is enabled. */
+    MVMint8 predecode_enabled;
+
     /* Number of specializations produced, and limit on number of
      * specializations (zero if no limit). */
     MVMint32 spesh_produced;
     MVMint32 spesh_limit;
 
+    /* Budget in bytes for the memory held by specializations (zero if no
+     * limit), and the estimated amount held by the ones not yet evicted.
+     * All candidates are kept in a list, so the least recently used ones can
+     * be evicted to stay within the budget; the eviction epoch is bumped each
+     * time the worker considers evicting. These are all protected by the
+     * candidates mutex. */
+    size_t spesh_memory_limit;
+    size_t spesh_memory_used;
+    MVMSpeshCandidate *spesh_candidates_head;
+    MVMuint32 spesh_eviction_epoch;
+    uv_mutex_t mutex_spesh_candidates;
+
     /* Mutex taken when install specializations. */
     uv_mutex_t mutex_spesh_install;
 
@@ -287,6 +316,13 @@ struct MVMInstance {
      * is enabled. */
     MVMObject *spesh_queue;
 
+    /* Number of helper threads that eagerly finish deserializing each SC
+     * as it is loaded (zero to only deserialize lazily), the threads, and
+     * the concurrent queue of SCs they take work from. */
+    MVMuint32  num_deserialize_threads;
+    MVMObject *deserialize_threads;
+    MVMObject *deserialize_queue;
+
     /* The current specialization plan; hung off here so we can mark it. */
     MVMSpeshPlan *spesh_plan;
 
@@ -309,6 +345,7 @@ struct MVMInstance {
     /* Flag for if jit is enabled */
     MVMuint8 jit_enabled;
     MVMuint8 jit_expr_enabled;
+    MVMuint8 jit_peephole_enabled;
     MVMuint8 jit_debug_enabled;
 
     /* bisection flags, to stop the JIT from using the expression compiler above
@@ -318,6 +355,11 @@ struct MVMInstance {
     MVMint32 jit_expr_last_bb;
     /* File for JIT perf map logging */
     FILE *jit_perf_map;
+    /* File for the perf jitdump, the executable mapping of it that perf
+     * looks for, and the index of the next code load record */
+    FILE      *jit_perf_dump;
+    void      *jit_perf_dump_marker;
+    MVMuint64  jit_perf_dump_index;
 
     /* Directory name for JIT bytecode dumps */
     char *jit_bytecode_dir;
@@ -367,6 +409,12 @@ struct MVMInstance {
     /* Any --libpath=... options, to prefix in loadbytecode lookups. */
     const char     *lib_path[8];
 
+    /* Directory of the on-disk validation cache (MVM_VALIDATION_CACHE), and
+     * the caches of all compilation units loaded so far. */
+    char           *validation_cache_dir;
+    uv_mutex_t      mutex_validation_caches;
+    MVM_VECTOR_DECL(MVMValidationCache *, validation_caches);
+
     /* Cache the environment hash */
     MVMObject      *env_hash;
 
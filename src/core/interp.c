@@ -144,6 +144,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
     /* The current call site we're constructing. */
     MVMCallsite *cur_callsite = NULL;
 
+    /* Depth of direct calls between JIT-compiled frames when we started. */
+    MVMuint32 jit_direct_call_depth;
+
     /* Stash addresses of current op, register base and SC deref base
      * in the TC; this will be used by anything that needs to switch
      * the current place we're interpreting. */
@@ -164,8 +167,11 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
         goto return_label;
 
     /* Set jump point, for if we arrive back in the interpreter from an
-     * exception thrown from C code. */
+     * exception thrown from C code. Any JIT-compiled code nested through
+     * direct calls is gone from the C stack by then. */
+    jit_direct_call_depth = tc->jit_direct_call_depth;
     setjmp(tc->interp_jump);
+    tc->jit_direct_call_depth = jit_direct_call_depth;
 
 #if !MVM_CGOTO
     /* Enter runloop. */
@@ -1224,7 +1230,7 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 cur_op += 2;
                 goto NEXT;
             OP(getcode):
-                GET_REG(cur_op, 0).o = cu->body.coderefs[GET_UI16(cur_op, 2)];
+                GET_REG(cur_op, 0).o = MVM_cu_coderef(tc, cu, GET_UI16(cur_op, 2));
                 cur_op += 4;
                 goto NEXT;
             OP(caller): {
@@ -1834,8 +1840,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMRegister *res  = &GET_REG(cur_op, 0);
                 MVMObject   *obj  = GET_REG(cur_op, 2).o;
                 MVMString   *name = MVM_cu_string(tc, cu, GET_UI32(cur_op, 4));
+                MVMuint8    *site = cur_op - 2;
                 cur_op += 8;
-                MVM_6model_find_method(tc, obj, name, res, 1);
+                MVM_inline_cache_find_method(tc, bytecode_start, site, obj, name, res);
                 goto NEXT;
             }
             OP(findmeth_s):  {
@@ -2108,10 +2115,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMObject *obj = GET_REG(cur_op, 2).o;
                 if (!IS_CONCRETE(obj))
                     MVM_exception_throw_adhoc(tc, "Cannot look up attributes in a %s type object", MVM_6model_get_debug_name(tc, obj));
-                REPR(obj)->attr_funcs.get_attribute(tc,
-                    STABLE(obj), obj, OBJECT_BODY(obj),
+                MVM_inline_cache_get_attribute(tc, bytecode_start, cur_op - 2, obj,
                     GET_REG(cur_op, 4).o, MVM_cu_string(tc, cu, GET_UI32(cur_op, 6)),
-                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0), MVM_reg_obj);
+                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0));
                 if (MVM_spesh_log_is_logging(tc))
                     MVM_spesh_log_type(tc, GET_REG(cur_op, 0).o);
                 cur_op += 12;
@@ -3315,17 +3321,20 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 if (REPR(maybe_cu)->ID == MVM_REPR_ID_MVMCompUnit) {
                     MVMCompUnit *cu = (MVMCompUnit *)maybe_cu;
                     if (cu->body.mainline_frame) {
-                        MVMObject *coderef;
+                        /* The mainline was created when the unit was
+                         * unpacked, so need not look at frames not yet
+                         * created. */
+                        MVMObject *coderef = NULL;
                         for (MVMuint32 i = 0; i < cu->body.num_frames; i++) {
-                            if (((MVMCode*)cu->body.coderefs[i])->body.sf == cu->body.mainline_frame) {
+                            if (cu->body.coderefs[i] && ((MVMCode*)cu->body.coderefs[i])->body.sf == cu->body.mainline_frame) {
                                 coderef = cu->body.coderefs[i];
                                 break;
                             }
                         }
-                        GET_REG(cur_op, 0).o = coderef ? coderef : cu->body.coderefs[0];
+                        GET_REG(cur_op, 0).o = coderef ? coderef : MVM_cu_coderef(tc, cu, 0);
                     }
                     else {
-                        GET_REG(cur_op, 0).o = cu->body.coderefs[0];
+                        GET_REG(cur_op, 0).o = MVM_cu_coderef(tc, cu, 0);
                     }
                 }
                 else {
@@ -3335,17 +3344,21 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 goto NEXT;
             }
             OP(compunitcodes): {
-                MVMObject *     const result = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
-                MVMCompUnit * const maybe_cu = (MVMCompUnit *)GET_REG(cur_op, 2).o;
+                MVMObject *   result   = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
+                MVMCompUnit * maybe_cu = (MVMCompUnit *)GET_REG(cur_op, 2).o;
                 CHECK_CONC(maybe_cu);
                 if (REPR(maybe_cu)->ID == MVM_REPR_ID_MVMCompUnit) {
                     const MVMuint32 num_frames  = maybe_cu->body.num_frames;
-                    MVMObject ** const coderefs = maybe_cu->body.coderefs;
                     MVMuint32 i;
 
-                    for (i = 0; i < num_frames; i++) {
-                        MVM_repr_push_o(tc, result, coderefs[i]);
-                    }
+                    /* Asking for all of them creates any frames not yet
+                     * created. */
+                    MVMROOT2(tc, result, maybe_cu, {
+                        for (i = 0; i < num_frames; i++) {
+                            MVMObject *coderef = MVM_cu_coderef(tc, maybe_cu, i);
+                            MVM_repr_push_o(tc, result, coderef);
+                        }
+                    });
 
                     GET_REG(cur_op, 0).o = result;
                 }
@@ -3784,6 +3797,7 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
             OP(exit): {
                 MVMint64 exit_code = GET_REG(cur_op, 0).i64;
                 MVM_io_flush_standard_handles(tc);
+                MVM_validation_cache_flush(tc->instance);
                 exit(exit_code);
             }
             OP(cwd):
@@ -5725,6 +5739,76 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 cur_op += 2;
                 goto NEXT;
             }
+            OP(freeze): {
+                MVMObject *buf = GET_REG(cur_op, 4).o;
+                MVM_serialization_freeze(tc, GET_REG(cur_op, 2).o, buf);
+                GET_REG(cur_op, 0).o = buf;
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(thaw):
+                GET_REG(cur_op, 0).o = MVM_serialization_thaw(tc,
+                    GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).i64);
+                cur_op += 6;
+                goto NEXT;
+            OP(serializetofh): {
+                MVMObject *sc  = GET_REG(cur_op, 2).o;
+                MVMObject *obj = GET_REG(cur_op, 4).o;
+                MVMObject *fh  = GET_REG(cur_op, 6).o;
+                if (REPR(sc)->ID != MVM_REPR_ID_SCRef)
+                    MVM_exception_throw_adhoc(tc,
+                        "Must provide an SCRef operand to serialize, got %s (%s)",
+                        REPR(sc)->name, MVM_6model_get_debug_name(tc, sc));
+                GET_REG(cur_op, 0).i64 = MVM_serialization_serialize_to_fh(
+                    tc,
+                    (MVMSerializationContext *)sc,
+                    obj,
+                    fh
+                );
+                cur_op += 8;
+                goto NEXT;
+            }
+            OP(bcwstring): {
+                MVMObject *writer = GET_REG(cur_op, 2).o;
+                MVM_bytecode_writer_ensure_writer(tc, writer, "bcwstring");
+                GET_REG(cur_op, 0).i64 = MVM_bytecode_writer_string(tc,
+                    (MVMBytecodeWriter *)writer, GET_REG(cur_op, 4).s);
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(bcwstrings): {
+                MVMObject *writer = GET_REG(cur_op, 2).o;
+                MVM_bytecode_writer_ensure_writer(tc, writer, "bcwstrings");
+                GET_REG(cur_op, 0).o = MVM_bytecode_writer_strings(tc, (MVMBytecodeWriter *)writer);
+                cur_op += 4;
+                goto NEXT;
+            }
+            OP(bcwcallsite): {
+                MVMObject *writer = GET_REG(cur_op, 2).o;
+                MVM_bytecode_writer_ensure_writer(tc, writer, "bcwcallsite");
+                GET_REG(cur_op, 0).i64 = MVM_bytecode_writer_callsite(tc,
+                    (MVMBytecodeWriter *)writer, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).o);
+                cur_op += 8;
+                goto NEXT;
+            }
+            OP(bcwframe): {
+                MVMObject *writer = GET_REG(cur_op, 2).o;
+                MVM_bytecode_writer_ensure_writer(tc, writer, "bcwframe");
+                GET_REG(cur_op, 0).i64 = MVM_bytecode_writer_frame(tc,
+                    (MVMBytecodeWriter *)writer, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).o,
+                    GET_REG(cur_op, 8).o);
+                cur_op += 10;
+                goto NEXT;
+            }
+            OP(bcwassemble): {
+                MVMObject *writer = GET_REG(cur_op, 2).o;
+                MVM_bytecode_writer_ensure_writer(tc, writer, "bcwassemble");
+                GET_REG(cur_op, 0).o = MVM_bytecode_writer_assemble(tc,
+                    (MVMBytecodeWriter *)writer, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).o,
+                    GET_REG(cur_op, 8).o);
+                cur_op += 10;
+                goto NEXT;
+            }
             OP(sp_guard): {
                 MVMRegister *target = &GET_REG(cur_op, 0);
                 MVMObject *check = GET_REG(cur_op, 2).o;
@@ -6683,6 +6767,126 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 cur_op += 8;
                 goto NEXT;
             }
+            OP(sp_deopt):
+                cur_op += 4;
+                MVM_spesh_deopt_one(tc, GET_UI32(cur_op, -4));
+                goto NEXT;
+            OP(sp_tailinvoke_o): {
+                MVMObject   *code = GET_REG(cur_op, 2).o;
+                MVMRegister *args = tc->cur_frame->args;
+                code = MVM_frame_find_invokee(tc, code, &cur_callsite);
+                tc->cur_frame->return_value = &GET_REG(cur_op, 0);
+                tc->cur_frame->return_type = MVM_RETURN_OBJ;
+                cur_op += 4;
+                tc->cur_frame->return_address = cur_op;
+                MVM_frame_tail_invoke(tc, code, cur_callsite, args);
+                goto NEXT;
+            }
+            /* Superinstructions execute the two ops they were fused from
+             * back to back, leaving cur_op exactly where it would be for
+             * each of them on its own. If the first one invokes, we go on
+             * from its return address, which is the second op. */
+            OP(sp_decont_istrue): {
+                MVMuint8 *prev_op = cur_op;
+                MVMObject *obj = GET_REG(cur_op, 2).o;
+                MVMRegister *r = &GET_REG(cur_op, 0);
+                cur_op += 4;
+                if (obj && IS_CONCRETE(obj) && STABLE(obj)->container_spec) {
+                    STABLE(obj)->container_spec->fetch(tc, obj, r);
+                    if (MVM_spesh_log_is_logging(tc))
+                        MVM_spesh_log_decont(tc, prev_op, r->o);
+                    if (cur_op != prev_op + 4)
+                        goto NEXT;
+                }
+                else {
+                    r->o = obj;
+                }
+                cur_op += 2;
+                obj = GET_REG(cur_op, 2).o;
+                r   = &GET_REG(cur_op, 0);
+                cur_op += 4;
+                MVM_coerce_istrue(tc, obj, r, NULL, NULL, 0);
+                goto NEXT;
+            }
+            OP(sp_const_i64_16_add_i):
+                GET_REG(cur_op, 0).i64 = GET_I16(cur_op, 2);
+                GET_REG(cur_op, 6).i64 = GET_REG(cur_op, 8).i64 + GET_REG(cur_op, 10).i64;
+                cur_op += 12;
+                goto NEXT;
+            OP(sp_getattr_o_decont): {
+                MVMObject *obj = GET_REG(cur_op, 2).o;
+                MVMuint8 *prev_op;
+                MVMRegister *r;
+                if (!IS_CONCRETE(obj))
+                    MVM_exception_throw_adhoc(tc, "Cannot look up attributes in a %s type object", MVM_6model_get_debug_name(tc, obj));
+                MVM_inline_cache_get_attribute(tc, bytecode_start, cur_op - 2, obj,
+                    GET_REG(cur_op, 4).o, MVM_cu_string(tc, cu, GET_UI32(cur_op, 6)),
+                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0));
+                if (MVM_spesh_log_is_logging(tc))
+                    MVM_spesh_log_type(tc, GET_REG(cur_op, 0).o);
+                cur_op += 14;
+                prev_op = cur_op;
+                obj = GET_REG(cur_op, 2).o;
+                r   = &GET_REG(cur_op, 0);
+                cur_op += 4;
+                if (obj && IS_CONCRETE(obj) && STABLE(obj)->container_spec) {
+                    STABLE(obj)->container_spec->fetch(tc, obj, r);
+                    if (MVM_spesh_log_is_logging(tc))
+                        MVM_spesh_log_decont(tc, prev_op, r->o);
+                }
+                else {
+                    r->o = obj;
+                }
+                goto NEXT;
+            }
+            OP(sp_eq_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 == GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_ne_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 != GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_lt_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 < GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_le_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 <= GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_gt_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 > GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_ge_i_unless_i):
+                if ((GET_REG(cur_op, 0).i64 = GET_REG(cur_op, 2).i64 >= GET_REG(cur_op, 4).i64))
+                    cur_op += 14;
+                else
+                    cur_op = bytecode_start + GET_UI32(cur_op, 10);
+                GC_SYNC_POINT(tc);
+                goto NEXT;
+            OP(sp_predecoded):
+                /* Run the pre-decoded code from the op this marks, which
+                 * hands back where to go on in the bytecode. */
+                cur_op = MVM_predecode_run(tc, tc->cur_frame->static_info,
+                    bytecode_start, cur_op - 2, reg_base);
+                goto NEXT;
 #if MVM_CGOTO
             OP_CALL_EXTOP: {
                 /* Bounds checking? Never heard of that. */
@@ -826,6 +826,14 @@ static const void * const LABELS[] = {
     &&OP_totalmem,
     &&OP_nextdispatcherfor,
     &&OP_takenextdispatcher,
+    &&OP_freeze,
+    &&OP_thaw,
+    &&OP_serializetofh,
+    &&OP_bcwstring,
+    &&OP_bcwstrings,
+    &&OP_bcwcallsite,
+    &&OP_bcwframe,
+    &&OP_bcwassemble,
     &&OP_sp_guard,
     &&OP_sp_guardconc,
     &&OP_sp_guardtype,
@@ -923,26 +931,18 @@ static const void * const LABELS[] = {
     &&OP_ctw_check,
     &&OP_coverage_log,
     &&OP_breakpoint,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
+    &&OP_sp_deopt,
+    &&OP_sp_tailinvoke_o,
+    &&OP_sp_decont_istrue,
+    &&OP_sp_const_i64_16_add_i,
+    &&OP_sp_getattr_o_decont,
+    &&OP_sp_eq_i_unless_i,
+    &&OP_sp_ne_i_unless_i,
+    &&OP_sp_lt_i_unless_i,
+    &&OP_sp_le_i_unless_i,
+    &&OP_sp_gt_i_unless_i,
+    &&OP_sp_ge_i_unless_i,
+    &&OP_sp_predecoded,
     NULL,
     NULL,
     NULL,
@@ -826,103 +826,123 @@
 #define MVM_OP_totalmem 822
 #define MVM_OP_nextdispatcherfor 823
 #define MVM_OP_takenextdispatcher 824
-#define MVM_OP_sp_guard 825
-#define MVM_OP_sp_guardconc 826
-#define MVM_OP_sp_guardtype 827
-#define MVM_OP_sp_guardsf 828
-#define MVM_OP_sp_guardsfouter 829
-#define MVM_OP_sp_guardobj 830
-#define MVM_OP_sp_guardnotobj 831
-#define MVM_OP_sp_guardjustconc 832
-#define MVM_OP_sp_guardjusttype 833
-#define MVM_OP_sp_rebless 834
-#define MVM_OP_sp_resolvecode 835
-#define MVM_OP_sp_decont 836
-#define MVM_OP_sp_getlex_o 837
-#define MVM_OP_sp_getlex_ins 838
-#define MVM_OP_sp_getlex_no 839
-#define MVM_OP_sp_bindlex_in 840
-#define MVM_OP_sp_bindlex_os 841
-#define MVM_OP_sp_getarg_o 842
-#define MVM_OP_sp_getarg_i 843
-#define MVM_OP_sp_getarg_n 844
-#define MVM_OP_sp_getarg_s 845
-#define MVM_OP_sp_fastinvoke_v 846
-#define MVM_OP_sp_fastinvoke_i 847
-#define MVM_OP_sp_fastinvoke_n 848
-#define MVM_OP_sp_fastinvoke_s 849
-#define MVM_OP_sp_fastinvoke_o 850
-#define MVM_OP_sp_speshresolve 851
-#define MVM_OP_sp_paramnamesused 852
-#define MVM_OP_sp_getspeshslot 853
-#define MVM_OP_sp_findmeth 854
-#define MVM_OP_sp_fastcreate 855
-#define MVM_OP_sp_get_o 856
-#define MVM_OP_sp_get_i64 857
-#define MVM_OP_sp_get_i32 858
-#define MVM_OP_sp_get_i16 859
-#define MVM_OP_sp_get_i8 860
-#define MVM_OP_sp_get_n 861
-#define MVM_OP_sp_get_s 862
-#define MVM_OP_sp_bind_o 863
-#define MVM_OP_sp_bind_i64 864
-#define MVM_OP_sp_bind_i32 865
-#define MVM_OP_sp_bind_i16 866
-#define MVM_OP_sp_bind_i8 867
-#define MVM_OP_sp_bind_n 868
-#define MVM_OP_sp_bind_s 869
-#define MVM_OP_sp_bind_s_nowb 870
-#define MVM_OP_sp_p6oget_o 871
-#define MVM_OP_sp_p6ogetvt_o 872
-#define MVM_OP_sp_p6ogetvc_o 873
-#define MVM_OP_sp_p6oget_i 874
-#define MVM_OP_sp_p6oget_n 875
-#define MVM_OP_sp_p6oget_s 876
-#define MVM_OP_sp_p6oget_bi 877
-#define MVM_OP_sp_p6obind_o 878
-#define MVM_OP_sp_p6obind_i 879
-#define MVM_OP_sp_p6obind_n 880
-#define MVM_OP_sp_p6obind_s 881
-#define MVM_OP_sp_p6oget_i32 882
-#define MVM_OP_sp_p6obind_i32 883
-#define MVM_OP_sp_getvt_o 884
-#define MVM_OP_sp_getvc_o 885
-#define MVM_OP_sp_fastbox_i 886
-#define MVM_OP_sp_fastbox_bi 887
-#define MVM_OP_sp_fastbox_i_ic 888
-#define MVM_OP_sp_fastbox_bi_ic 889
-#define MVM_OP_sp_deref_get_i64 890
-#define MVM_OP_sp_deref_get_n 891
-#define MVM_OP_sp_deref_bind_i64 892
-#define MVM_OP_sp_deref_bind_n 893
-#define MVM_OP_sp_getlexvia_o 894
-#define MVM_OP_sp_getlexvia_ins 895
-#define MVM_OP_sp_bindlexvia_os 896
-#define MVM_OP_sp_bindlexvia_in 897
-#define MVM_OP_sp_getstringfrom 898
-#define MVM_OP_sp_getwvalfrom 899
-#define MVM_OP_sp_jit_enter 900
-#define MVM_OP_sp_istrue_n 901
-#define MVM_OP_sp_boolify_iter 902
-#define MVM_OP_sp_boolify_iter_arr 903
-#define MVM_OP_sp_boolify_iter_hash 904
-#define MVM_OP_sp_cas_o 905
-#define MVM_OP_sp_atomicload_o 906
-#define MVM_OP_sp_atomicstore_o 907
-#define MVM_OP_sp_add_I 908
-#define MVM_OP_sp_sub_I 909
-#define MVM_OP_sp_mul_I 910
-#define MVM_OP_sp_bool_I 911
-#define MVM_OP_prof_enter 912
-#define MVM_OP_prof_enterspesh 913
-#define MVM_OP_prof_enterinline 914
-#define MVM_OP_prof_enternative 915
-#define MVM_OP_prof_exit 916
-#define MVM_OP_prof_allocated 917
-#define MVM_OP_prof_replaced 918
-#define MVM_OP_ctw_check 919
-#define MVM_OP_coverage_log 920
-#define MVM_OP_breakpoint 921
+#define MVM_OP_freeze 825
+#define MVM_OP_thaw 826
+#define MVM_OP_serializetofh 827
+#define MVM_OP_bcwstring 828
+#define MVM_OP_bcwstrings 829
+#define MVM_OP_bcwcallsite 830
+#define MVM_OP_bcwframe 831
+#define MVM_OP_bcwassemble 832
+#define MVM_OP_sp_guard 833
+#define MVM_OP_sp_guardconc 834
+#define MVM_OP_sp_guardtype 835
+#define MVM_OP_sp_guardsf 836
+#define MVM_OP_sp_guardsfouter 837
+#define MVM_OP_sp_guardobj 838
+#define MVM_OP_sp_guardnotobj 839
+#define MVM_OP_sp_guardjustconc 840
+#define MVM_OP_sp_guardjusttype 841
+#define MVM_OP_sp_rebless 842
+#define MVM_OP_sp_resolvecode 843
+#define MVM_OP_sp_decont 844
+#define MVM_OP_sp_getlex_o 845
+#define MVM_OP_sp_getlex_ins 846
+#define MVM_OP_sp_getlex_no 847
+#define MVM_OP_sp_bindlex_in 848
+#define MVM_OP_sp_bindlex_os 849
+#define MVM_OP_sp_getarg_o 850
+#define MVM_OP_sp_getarg_i 851
+#define MVM_OP_sp_getarg_n 852
+#define MVM_OP_sp_getarg_s 853
+#define MVM_OP_sp_fastinvoke_v 854
+#define MVM_OP_sp_fastinvoke_i 855
+#define MVM_OP_sp_fastinvoke_n 856
+#define MVM_OP_sp_fastinvoke_s 857
+#define MVM_OP_sp_fastinvoke_o 858
+#define MVM_OP_sp_speshresolve 859
+#define MVM_OP_sp_paramnamesused 860
+#define MVM_OP_sp_getspeshslot 861
+#define MVM_OP_sp_findmeth 862
+#define MVM_OP_sp_fastcreate 863
+#define MVM_OP_sp_get_o 864
+#define MVM_OP_sp_get_i64 865
+#define MVM_OP_sp_get_i32 866
+#define MVM_OP_sp_get_i16 867
+#define MVM_OP_sp_get_i8 868
+#define MVM_OP_sp_get_n 869
+#define MVM_OP_sp_get_s 870
+#define MVM_OP_sp_bind_o 871
+#define MVM_OP_sp_bind_i64 872
+#define MVM_OP_sp_bind_i32 873
+#define MVM_OP_sp_bind_i16 874
+#define MVM_OP_sp_bind_i8 875
+#define MVM_OP_sp_bind_n 876
+#define MVM_OP_sp_bind_s 877
+#define MVM_OP_sp_bind_s_nowb 878
+#define MVM_OP_sp_p6oget_o 879
+#define MVM_OP_sp_p6ogetvt_o 880
+#define MVM_OP_sp_p6ogetvc_o 881
+#define MVM_OP_sp_p6oget_i 882
+#define MVM_OP_sp_p6oget_n 883
+#define MVM_OP_sp_p6oget_s 884
+#define MVM_OP_sp_p6oget_bi 885
+#define MVM_OP_sp_p6obind_o 886
+#define MVM_OP_sp_p6obind_i 887
+#define MVM_OP_sp_p6obind_n 888
+#define MVM_OP_sp_p6obind_s 889
+#define MVM_OP_sp_p6oget_i32 890
+#define MVM_OP_sp_p6obind_i32 891
+#define MVM_OP_sp_getvt_o 892
+#define MVM_OP_sp_getvc_o 893
+#define MVM_OP_sp_fastbox_i 894
+#define MVM_OP_sp_fastbox_bi 895
+#define MVM_OP_sp_fastbox_i_ic 896
+#define MVM_OP_sp_fastbox_bi_ic 897
+#define MVM_OP_sp_deref_get_i64 898
+#define MVM_OP_sp_deref_get_n 899
+#define MVM_OP_sp_deref_bind_i64 900
+#define MVM_OP_sp_deref_bind_n 901
+#define MVM_OP_sp_getlexvia_o 902
+#define MVM_OP_sp_getlexvia_ins 903
+#define MVM_OP_sp_bindlexvia_os 904
+#define MVM_OP_sp_bindlexvia_in 905
+#define MVM_OP_sp_getstringfrom 906
+#define MVM_OP_sp_getwvalfrom 907
+#define MVM_OP_sp_jit_enter 908
+#define MVM_OP_sp_istrue_n 909
+#define MVM_OP_sp_boolify_iter 910
+#define MVM_OP_sp_boolify_iter_arr 911
+#define MVM_OP_sp_boolify_iter_hash 912
+#define MVM_OP_sp_cas_o 913
+#define MVM_OP_sp_atomicload_o 914
+#define MVM_OP_sp_atomicstore_o 915
+#define MVM_OP_sp_add_I 916
+#define MVM_OP_sp_sub_I 917
+#define MVM_OP_sp_mul_I 918
+#define MVM_OP_sp_bool_I 919
+#define MVM_OP_prof_enter 920
+#define MVM_OP_prof_enterspesh 921
+#define MVM_OP_prof_enterinline 922
+#define MVM_OP_prof_enternative 923
+#define MVM_OP_prof_exit 924
+#define MVM_OP_prof_allocated 925
+#define MVM_OP_prof_replaced 926
+#define MVM_OP_ctw_check 927
+#define MVM_OP_coverage_log 928
+#define MVM_OP_breakpoint 929
+#define MVM_OP_sp_deopt 930
+#define MVM_OP_sp_tailinvoke_o 931
+#define MVM_OP_sp_decont_istrue 932
+#define MVM_OP_sp_const_i64_16_add_i 933
+#define MVM_OP_sp_getattr_o_decont 934
+#define MVM_OP_sp_eq_i_unless_i 935
+#define MVM_OP_sp_ne_i_unless_i 936
+#define MVM_OP_sp_lt_i_unless_i 937
+#define MVM_OP_sp_le_i_unless_i 938
+#define MVM_OP_sp_gt_i_unless_i 939
+#define MVM_OP_sp_ge_i_unless_i 940
+#define MVM_OP_sp_predecoded 941
 
 #define MVM_OP_EXT_BASE 1024
 #define MVM_OP_EXT_CU_LIMIT 1024
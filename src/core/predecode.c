@@ -0,0 +1,639 @@
+#include "moar.h"
+
+/* Macros for getting things from the bytecode stream. */
+#define GET_I8(pc, idx)     *((MVMint8 *)(pc + idx))
+#define GET_I16(pc, idx)    *((MVMint16 *)(pc + idx))
+#define GET_UI16(pc, idx)   *((MVMuint16 *)(pc + idx))
+
+MVM_STATIC_INLINE MVMint32 GET_I32(const MVMuint8 *pc, MVMint32 idx) {
+    MVMint32 retval;
+    memcpy(&retval, pc + idx, sizeof(retval));
+    return retval;
+}
+
+MVM_STATIC_INLINE MVMuint32 GET_UI32(const MVMuint8 *pc, MVMint32 idx) {
+    MVMuint32 retval;
+    memcpy(&retval, pc + idx, sizeof(retval));
+    return retval;
+}
+
+/* The ops that can run pre-decoded. None of them can throw, allocate or
+ * invoke, so the only ways out of the code are a bail, at an op that is not
+ * in this list, and an OSR at an osrpoint. */
+#define MVM_PREDECODE_OPS(X) \
+    X(bail) X(osrpoint) X(goto) X(if_i) X(unless_i) X(if_n) X(unless_n) \
+    X(set) X(const_i) X(const_n) \
+    X(add_i) X(sub_i) X(mul_i) X(neg_i) X(abs_i) X(inc_i) X(dec_i) \
+    X(band_i) X(bor_i) X(bxor_i) X(bnot_i) X(blshift_i) X(brshift_i) X(not_i) \
+    X(eq_i) X(ne_i) X(lt_i) X(le_i) X(gt_i) X(ge_i) X(cmp_i) \
+    X(add_n) X(sub_n) X(mul_n) X(div_n) X(neg_n) \
+    X(eq_n) X(ne_n) X(lt_n) X(le_n) X(gt_n) X(ge_n) X(cmp_n) \
+    X(coerce_in) X(coerce_ni) X(no_op)
+
+enum {
+#define PREDECODE_ENUM(name) T_ ## name,
+    MVM_PREDECODE_OPS(PREDECODE_ENUM)
+#undef PREDECODE_ENUM
+    T_num_ops
+};
+
+/* Maps an op to the one that runs it pre-decoded, or to T_bail if it has to
+ * be left to the interpreter. The constants all widen their literal, so one
+ * threaded op covers each of them. */
+static MVMuint8 threaded_op(MVMuint16 opcode) {
+    switch (opcode) {
+        case MVM_OP_osrpoint:     return T_osrpoint;
+        case MVM_OP_goto:         return T_goto;
+        case MVM_OP_if_i:         return T_if_i;
+        case MVM_OP_unless_i:     return T_unless_i;
+        case MVM_OP_if_n:         return T_if_n;
+        case MVM_OP_unless_n:     return T_unless_n;
+        case MVM_OP_set:          return T_set;
+        case MVM_OP_const_i64:
+        case MVM_OP_const_i64_16:
+        case MVM_OP_const_i64_32: return T_const_i;
+        case MVM_OP_const_n64:    return T_const_n;
+        case MVM_OP_add_i:        return T_add_i;
+        case MVM_OP_sub_i:        return T_sub_i;
+        case MVM_OP_mul_i:        return T_mul_i;
+        case MVM_OP_neg_i:        return T_neg_i;
+        case MVM_OP_abs_i:        return T_abs_i;
+        case MVM_OP_inc_i:        return T_inc_i;
+        case MVM_OP_dec_i:        return T_dec_i;
+        case MVM_OP_band_i:       return T_band_i;
+        case MVM_OP_bor_i:        return T_bor_i;
+        case MVM_OP_bxor_i:       return T_bxor_i;
+        case MVM_OP_bnot_i:       return T_bnot_i;
+        case MVM_OP_blshift_i:    return T_blshift_i;
+        case MVM_OP_brshift_i:    return T_brshift_i;
+        case MVM_OP_not_i:        return T_not_i;
+        case MVM_OP_eq_i:         return T_eq_i;
+        case MVM_OP_ne_i:         return T_ne_i;
+        case MVM_OP_lt_i:         return T_lt_i;
+        case MVM_OP_le_i:         return T_le_i;
+        case MVM_OP_gt_i:         return T_gt_i;
+        case MVM_OP_ge_i:         return T_ge_i;
+        case MVM_OP_cmp_i:        return T_cmp_i;
+        case MVM_OP_add_n:        return T_add_n;
+        case MVM_OP_sub_n:        return T_sub_n;
+        case MVM_OP_mul_n:        return T_mul_n;
+        case MVM_OP_div_n:        return T_div_n;
+        case MVM_OP_neg_n:        return T_neg_n;
+        case MVM_OP_eq_n:         return T_eq_n;
+        case MVM_OP_ne_n:         return T_ne_n;
+        case MVM_OP_lt_n:         return T_lt_n;
+        case MVM_OP_le_n:         return T_le_n;
+        case MVM_OP_gt_n:         return T_gt_n;
+        case MVM_OP_ge_n:         return T_ge_n;
+        case MVM_OP_cmp_n:        return T_cmp_n;
+        case MVM_OP_coerce_in:    return T_coerce_in;
+        case MVM_OP_coerce_ni:    return T_coerce_ni;
+        case MVM_OP_no_op:        return T_no_op;
+        default:                  return T_bail;
+    }
+}
+
+/* Ops that keep the offset of their op in the bytecode in a trailing cell,
+ * so that the interpreter state can be brought up to date before a GC sync
+ * point or an OSR. */
+static MVMuint8 keeps_offset(MVMuint8 op) {
+    switch (op) {
+        case T_osrpoint:
+        case T_goto:
+        case T_if_i:
+        case T_unless_i:
+        case T_if_n:
+        case T_unless_n:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* Runs pre-decoded code from pc until it has to go back to the interpreter,
+ * returning where in the bytecode to go on. If labels is not NULL, it just
+ * hands back the handler of each op instead. */
+static MVMuint8 * run(MVMThreadContext *tc, MVMPredecodedCell *code, MVMPredecodedCell *pc,
+        MVMuint8 *bytecode_start, MVMRegister *reg_base, const void * const **labels) {
+#if MVM_CGOTO
+#define PREDECODE_LABEL(name) &&OP_ ## name,
+    static const void * const LABELS[] = {
+        MVM_PREDECODE_OPS(PREDECODE_LABEL)
+    };
+#undef PREDECODE_LABEL
+#define CASE(name) OP_ ## name
+#define NEXT goto *(pc->handler)
+    if (labels) {
+        *labels = LABELS;
+        return NULL;
+    }
+    NEXT;
+#else
+#define CASE(name) case T_ ## name
+#define NEXT goto dispatch
+    if (labels)
+        return NULL;
+  dispatch:
+    switch (pc->op) {
+#endif
+
+#define REG(idx) reg_base[pc[idx].reg]
+#define SYNC_POINT(offset_idx) \
+    if (tc->gc_status) { \
+        *(tc->interp_cur_op) = bytecode_start + pc[offset_idx].offset + 2; \
+        MVM_gc_enter_from_interrupt(tc); \
+    }
+
+        CASE(bail):
+            return bytecode_start + pc[1].offset;
+        CASE(osrpoint):
+            /* Log and poll as the interpreter does, which finds the osrpoint
+             * from where it thinks we are. If that replaced the frame's code,
+             * it also updated the interpreter to go on in the new code. */
+            *(tc->interp_cur_op) = bytecode_start + pc[1].offset + 2;
+            if (MVM_spesh_log_is_logging(tc))
+                MVM_spesh_log_osr(tc);
+            MVM_spesh_osr_poll_for_result(tc);
+            if (*(tc->interp_bytecode_start) != bytecode_start)
+                return *(tc->interp_cur_op);
+            pc += 2;
+            NEXT;
+        CASE(goto):
+            SYNC_POINT(2);
+            pc = code + pc[1].target;
+            NEXT;
+        CASE(if_i):
+            SYNC_POINT(3);
+            pc = REG(1).i64 ? code + pc[2].target : pc + 4;
+            NEXT;
+        CASE(unless_i):
+            SYNC_POINT(3);
+            pc = REG(1).i64 ? pc + 4 : code + pc[2].target;
+            NEXT;
+        CASE(if_n):
+            SYNC_POINT(3);
+            pc = REG(1).n64 != 0.0 ? code + pc[2].target : pc + 4;
+            NEXT;
+        CASE(unless_n):
+            SYNC_POINT(3);
+            pc = REG(1).n64 != 0.0 ? pc + 4 : code + pc[2].target;
+            NEXT;
+        CASE(set):
+            REG(1) = REG(2);
+            pc += 3;
+            NEXT;
+        CASE(const_i):
+            REG(1).i64 = pc[2].i64;
+            pc += 3;
+            NEXT;
+        CASE(const_n):
+            REG(1).n64 = pc[2].n64;
+            pc += 3;
+            NEXT;
+        CASE(add_i):
+            REG(1).i64 = REG(2).i64 + REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(sub_i):
+            REG(1).i64 = REG(2).i64 - REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(mul_i):
+            REG(1).i64 = REG(2).i64 * REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(neg_i):
+            REG(1).i64 = -REG(2).i64;
+            pc += 3;
+            NEXT;
+        CASE(abs_i): {
+            MVMint64 v    = REG(2).i64;
+            MVMint64 mask = v >> 63;
+            REG(1).i64 = (v + mask) ^ mask;
+            pc += 3;
+            NEXT;
+        }
+        CASE(inc_i):
+            REG(1).i64++;
+            pc += 2;
+            NEXT;
+        CASE(dec_i):
+            REG(1).i64--;
+            pc += 2;
+            NEXT;
+        CASE(band_i):
+            REG(1).i64 = REG(2).i64 & REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(bor_i):
+            REG(1).i64 = REG(2).i64 | REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(bxor_i):
+            REG(1).i64 = REG(2).i64 ^ REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(bnot_i):
+            REG(1).i64 = ~REG(2).i64;
+            pc += 3;
+            NEXT;
+        CASE(blshift_i):
+            REG(1).i64 = REG(2).i64 << REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(brshift_i):
+            REG(1).i64 = REG(2).i64 >> REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(not_i):
+            REG(1).i64 = REG(2).i64 ? 0 : 1;
+            pc += 3;
+            NEXT;
+        CASE(eq_i):
+            REG(1).i64 = REG(2).i64 == REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(ne_i):
+            REG(1).i64 = REG(2).i64 != REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(lt_i):
+            REG(1).i64 = REG(2).i64 <  REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(le_i):
+            REG(1).i64 = REG(2).i64 <= REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(gt_i):
+            REG(1).i64 = REG(2).i64 >  REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(ge_i):
+            REG(1).i64 = REG(2).i64 >= REG(3).i64;
+            pc += 4;
+            NEXT;
+        CASE(cmp_i): {
+            MVMint64 a = REG(2).i64, b = REG(3).i64;
+            REG(1).i64 = (a > b) - (a < b);
+            pc += 4;
+            NEXT;
+        }
+        CASE(add_n):
+            REG(1).n64 = REG(2).n64 + REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(sub_n):
+            REG(1).n64 = REG(2).n64 - REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(mul_n):
+            REG(1).n64 = REG(2).n64 * REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(div_n):
+            REG(1).n64 = REG(2).n64 / REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(neg_n):
+            REG(1).n64 = -REG(2).n64;
+            pc += 3;
+            NEXT;
+        CASE(eq_n):
+            REG(1).i64 = REG(2).n64 == REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(ne_n):
+            REG(1).i64 = REG(2).n64 != REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(lt_n):
+            REG(1).i64 = REG(2).n64 <  REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(le_n):
+            REG(1).i64 = REG(2).n64 <= REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(gt_n):
+            REG(1).i64 = REG(2).n64 >  REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(ge_n):
+            REG(1).i64 = REG(2).n64 >= REG(3).n64;
+            pc += 4;
+            NEXT;
+        CASE(cmp_n): {
+            MVMnum64 a = REG(2).n64, b = REG(3).n64;
+            REG(1).i64 = (a > b) - (a < b);
+            pc += 4;
+            NEXT;
+        }
+        CASE(coerce_in):
+            REG(1).n64 = (MVMnum64)REG(2).i64;
+            pc += 3;
+            NEXT;
+        CASE(coerce_ni):
+            REG(1).i64 = (MVMint64)REG(2).n64;
+            pc += 3;
+            NEXT;
+        CASE(no_op):
+            pc += 1;
+            NEXT;
+
+#if !MVM_CGOTO
+        default:
+            MVM_oops(tc, "Pre-decoded code has an unknown op %"PRIu64, pc->op);
+    }
+#endif
+
+#undef SYNC_POINT
+#undef REG
+#undef NEXT
+#undef CASE
+}
+
+/* What we know about an op of the bytecode while pre-decoding it. */
+typedef struct {
+    MVMuint32        offset;
+    MVMuint32        cell;
+    const MVMOpInfo *info;
+    MVMuint8         threaded;
+    MVMuint8         is_label;
+} PredecodeOp;
+
+/* Gets the size in the bytecode of an operand of a regular op. */
+static MVMuint32 operand_size(MVMThreadContext *tc, MVMuint8 flags) {
+    switch (flags & MVM_operand_rw_mask) {
+        case MVM_operand_read_reg:
+        case MVM_operand_write_reg:
+            return 2;
+        case MVM_operand_read_lex:
+        case MVM_operand_write_lex:
+            return 4;
+    }
+    switch (flags & MVM_operand_type_mask) {
+        case MVM_operand_int8:
+        case MVM_operand_uint8:
+            return 1;
+        case MVM_operand_int16:
+        case MVM_operand_uint16:
+        case MVM_operand_callsite:
+        case MVM_operand_coderef:
+        case MVM_operand_spesh_slot:
+            return 2;
+        case MVM_operand_int32:
+        case MVM_operand_uint32:
+        case MVM_operand_num32:
+        case MVM_operand_str:
+        case MVM_operand_ins:
+            return 4;
+        case MVM_operand_int64:
+        case MVM_operand_uint64:
+        case MVM_operand_num64:
+            return 8;
+        default:
+            MVM_oops(tc, "Pre-decode: unknown operand type %d", (int)(flags & MVM_operand_type_mask));
+    }
+}
+
+/* Finds the op at a bytecode offset; the ops are ordered by offset. */
+static PredecodeOp * find_op(PredecodeOp *ops, MVMuint32 num_ops, MVMuint32 offset) {
+    MVMuint32 lo = 0, hi = num_ops;
+    while (lo < hi) {
+        MVMuint32 mid = lo + (hi - lo) / 2;
+        if (ops[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < num_ops && ops[lo].offset == offset ? &ops[lo] : NULL;
+}
+
+/* Pre-decodes the ops of a static frame that can run without the
+ * interpreter into direct-threaded code, and marks the places where the
+ * bytecode should enter it. Frames with no run of such ops long enough, or
+ * looping, to pay back the dispatch into it are left alone. */
+void MVM_predecode_static_frame(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    MVMStaticFrameBody *fb = &sf->body;
+    MVMCompUnit *cu = fb->cu;
+    MVMuint8 *bc = fb->bytecode;
+    MVMuint32 size = fb->bytecode_size;
+    PredecodeOp *ops;
+    MVMuint32 num_ops = 0, num_cells = 0, num_entries = 0;
+    MVMuint32 pos, i, j, k;
+    MVMPredecoded *pd;
+    const void * const *labels = NULL;
+
+    if (fb->predecoded)
+        return;
+
+    /* Find the ops, what runs each of them, and where their cells go. An op
+     * takes at least two bytes, so that bounds how many there can be. */
+    ops = MVM_malloc((size / 2 + 1) * sizeof(PredecodeOp));
+    for (pos = 0; pos < size; num_ops++) {
+        PredecodeOp *op = &ops[num_ops];
+        MVMuint16 opcode = GET_UI16(bc, pos);
+        op->offset   = pos;
+        op->cell     = num_cells;
+        op->is_label = 0;
+        pos += 2;
+        if (opcode < MVM_OP_EXT_BASE) {
+            op->info     = MVM_op_get_op(MVM_validate_unfuse_op(opcode));
+            op->threaded = threaded_op(op->info->opcode);
+            for (i = 0; i < op->info->num_operands; i++)
+                pos += operand_size(tc, op->info->operands[i]);
+        }
+        else {
+            op->info     = NULL;
+            op->threaded = T_bail;
+            pos += cu->body.extops[opcode - MVM_OP_EXT_BASE].operand_bytes;
+        }
+        num_cells += op->threaded == T_bail
+            ? 2
+            : 1 + op->info->num_operands + keeps_offset(op->threaded);
+    }
+
+    /* Mark the labels: branch targets, and where handlers go to. */
+    for (i = 0; i < num_ops; i++) {
+        const MVMOpInfo *info = ops[i].info;
+        MVMuint32 arg = ops[i].offset + 2;
+        if (!info)
+            continue;
+        for (j = 0; j < info->num_operands; j++) {
+            if ((info->operands[j] & MVM_operand_rw_mask) == MVM_operand_literal
+                    && (info->operands[j] & MVM_operand_type_mask) == MVM_operand_ins) {
+                PredecodeOp *target = find_op(ops, num_ops, GET_UI32(bc, arg));
+                if (target)
+                    target->is_label = 1;
+            }
+            arg += operand_size(tc, info->operands[j]);
+        }
+    }
+    for (i = 0; i < fb->num_handlers; i++) {
+        if (fb->handlers[i].goto_offset != (MVMuint32)-1) {
+            PredecodeOp *target = find_op(ops, num_ops, fb->handlers[i].goto_offset);
+            if (target)
+                target->is_label = 1;
+        }
+    }
+
+    /* Pick the entries. A run of ops the interpreter can get to other than
+     * through the op before it is worth entering if it is long enough, or if
+     * it branches back into itself, since then it is a loop. We keep that in
+     * the threaded op of the entries, setting the top bit, until we know how
+     * many there are. */
+    for (i = 0; i < num_ops; i++) {
+        MVMuint32 end;
+        MVMuint8 loops = 0;
+        if (ops[i].threaded == T_bail)
+            continue;
+        if (i > 0 && ops[i - 1].threaded != T_bail && !ops[i].is_label)
+            continue;
+        for (end = i; end < num_ops && ops[end].threaded != T_bail; end++) {
+            const MVMOpInfo *info = ops[end].info;
+            MVMuint32 arg = ops[end].offset + 2;
+            for (j = 0; j < info->num_operands; j++) {
+                if ((info->operands[j] & MVM_operand_rw_mask) == MVM_operand_literal
+                        && (info->operands[j] & MVM_operand_type_mask) == MVM_operand_ins) {
+                    MVMuint32 target = GET_UI32(bc, arg);
+                    if (target >= ops[i].offset && target <= ops[end].offset)
+                        loops = 1;
+                }
+                arg += operand_size(tc, info->operands[j]);
+            }
+        }
+        if (loops || end - i >= MVM_PREDECODE_MIN_RUN) {
+            ops[i].threaded |= 0x80;
+            num_entries++;
+        }
+    }
+    if (!num_entries) {
+        MVM_free(ops);
+        return;
+    }
+
+    /* Emit the code. */
+#if MVM_CGOTO
+    run(tc, NULL, NULL, NULL, NULL, &labels);
+#endif
+    pd = MVM_calloc(1, sizeof(MVMPredecoded));
+    pd->code          = MVM_malloc(num_cells * sizeof(MVMPredecodedCell));
+    pd->num_cells     = num_cells;
+    pd->entry_offsets = MVM_malloc(num_entries * sizeof(MVMuint32));
+    pd->entry_cells   = MVM_malloc(num_entries * sizeof(MVMuint32));
+    pd->entry_ops     = MVM_malloc(num_entries * sizeof(MVMuint16));
+    pd->num_entries   = num_entries;
+    for (i = 0, k = 0; i < num_ops; i++) {
+        PredecodeOp *op = &ops[i];
+        MVMPredecodedCell *cell = pd->code + op->cell;
+        MVMuint8 threaded = op->threaded & 0x7F;
+        MVMuint32 arg = op->offset + 2;
+
+        if (op->threaded & 0x80) {
+            pd->entry_offsets[k] = op->offset;
+            pd->entry_cells[k]   = op->cell;
+            pd->entry_ops[k]     = GET_UI16(bc, op->offset);
+            k++;
+        }
+
+        if (labels)
+            (cell++)->handler = labels[threaded];
+        else
+            (cell++)->op = threaded;
+        if (threaded == T_bail) {
+            cell->offset = op->offset;
+            continue;
+        }
+        for (j = 0; j < op->info->num_operands; j++) {
+            MVMuint8 flags = op->info->operands[j];
+            switch (flags & MVM_operand_rw_mask) {
+                case MVM_operand_read_reg:
+                case MVM_operand_write_reg:
+                    cell->reg = GET_UI16(bc, arg);
+                    break;
+                default:
+                    switch (flags & MVM_operand_type_mask) {
+                        case MVM_operand_int16:
+                            cell->i64 = GET_I16(bc, arg);
+                            break;
+                        case MVM_operand_int32:
+                            cell->i64 = GET_I32(bc, arg);
+                            break;
+                        case MVM_operand_int64:
+                            cell->i64 = MVM_BC_get_I64(bc, arg);
+                            break;
+                        case MVM_operand_num64:
+                            cell->n64 = MVM_BC_get_N64(bc, arg);
+                            break;
+                        case MVM_operand_ins:
+                            cell->target = find_op(ops, num_ops, GET_UI32(bc, arg))->cell;
+                            break;
+                        default:
+                            MVM_oops(tc, "Pre-decode: unexpected operand of %s", op->info->name);
+                    }
+            }
+            arg += operand_size(tc, flags);
+            cell++;
+        }
+        if (keeps_offset(threaded))
+            cell->offset = op->offset;
+    }
+
+    /* Mark the entries in the bytecode, copying it first if we do not own
+     * it yet. */
+    if (fb->bytecode == fb->orig_bytecode) {
+        fb->bytecode = MVM_malloc(size);
+        memcpy(fb->bytecode, bc, size);
+    }
+    for (k = 0; k < num_entries; k++)
+        *((MVMuint16 *)(fb->bytecode + pd->entry_offsets[k])) = MVM_OP_sp_predecoded;
+
+    fb->predecoded = pd;
+    MVM_free(ops);
+}
+
+/* Finds the entry that a marker in the bytecode of a frame stands for. */
+static MVMuint32 find_entry(MVMThreadContext *tc, MVMPredecoded *pd, MVMuint32 offset) {
+    MVMuint32 lo = 0, hi = pd ? pd->num_entries : 0;
+    while (lo < hi) {
+        MVMuint32 mid = lo + (hi - lo) / 2;
+        if (pd->entry_offsets[mid] < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (!pd || lo == pd->num_entries || pd->entry_offsets[lo] != offset)
+        MVM_oops(tc, "No pre-decoded entry at bytecode offset %"PRIu32, offset);
+    return lo;
+}
+
+/* Runs the pre-decoded code of a frame from the entry that a marker stands
+ * for, returning where the interpreter should go on. */
+MVMuint8 * MVM_predecode_run(MVMThreadContext *tc, MVMStaticFrame *sf, MVMuint8 *bytecode_start,
+        MVMuint8 *marker, MVMRegister *reg_base) {
+    MVMPredecoded *pd = sf->body.predecoded;
+    MVMuint32 entry = find_entry(tc, pd, marker - bytecode_start);
+    return run(tc, pd->code, pd->code + pd->entry_cells[entry], bytecode_start, reg_base, NULL);
+}
+
+/* Gets the opcode that a marker in the bytecode of a frame replaced, for
+ * code that reads the bytecode rather than running it. */
+MVMuint16 MVM_predecode_orig_op(MVMThreadContext *tc, MVMStaticFrame *sf, MVMuint32 offset) {
+    MVMPredecoded *pd = sf->body.predecoded;
+    return pd->entry_ops[find_entry(tc, pd, offset)];
+}
+
+MVMuint64 MVM_predecode_allocated_size(MVMThreadContext *tc, MVMPredecoded *pd) {
+    return sizeof(MVMPredecoded)
+        + pd->num_cells * sizeof(MVMPredecodedCell)
+        + pd->num_entries * (2 * sizeof(MVMuint32) + sizeof(MVMuint16));
+}
+
+void MVM_predecode_destroy(MVMThreadContext *tc, MVMPredecoded *pd) {
+    MVM_free(pd->code);
+    MVM_free(pd->entry_offsets);
+    MVM_free(pd->entry_cells);
+    MVM_free(pd->entry_ops);
+    MVM_free(pd);
+}
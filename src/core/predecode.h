@@ -0,0 +1,46 @@
+/* How many ops a run that does not loop needs before it is worth entering
+ * pre-decoded code for it. */
+#define MVM_PREDECODE_MIN_RUN 8
+
+/* A cell of pre-decoded code: an op's handler, or one of its operands, widened
+ * so that no decoding is needed when it runs. */
+union MVMPredecodedCell {
+    /* The handler of the op, when we have computed goto, and otherwise the
+     * number of the op to switch on. */
+    const void *handler;
+    MVMuint64   op;
+
+    /* A register index, the cell index of a branch target, or the offset in
+     * the bytecode of the op the cell belongs to. */
+    MVMuint64   reg;
+    MVMuint64   target;
+    MVMuint64   offset;
+
+    /* A literal. */
+    MVMint64    i64;
+    MVMnum64    n64;
+};
+
+/* The pre-decoded, direct-threaded code of a static frame. Each op that can
+ * be run this way is its handler followed by its operands; any other op is a
+ * bail out to the interpreter at its offset, so branches can target it. The
+ * unspecialized bytecode enters the code where it is worthwhile, through the
+ * sp_predecoded op, which replaces the opcode of the first op run there. */
+struct MVMPredecoded {
+    MVMPredecodedCell *code;
+    MVMuint32 num_cells;
+
+    /* The entry points, ordered by the bytecode offset of their marker, with
+     * the cell index they start at and the opcode the marker replaced. */
+    MVMuint32 *entry_offsets;
+    MVMuint32 *entry_cells;
+    MVMuint16 *entry_ops;
+    MVMuint32 num_entries;
+};
+
+void MVM_predecode_static_frame(MVMThreadContext *tc, MVMStaticFrame *sf);
+MVMuint8 * MVM_predecode_run(MVMThreadContext *tc, MVMStaticFrame *sf, MVMuint8 *bytecode_start,
+    MVMuint8 *marker, MVMRegister *reg_base);
+MVMuint16 MVM_predecode_orig_op(MVMThreadContext *tc, MVMStaticFrame *sf, MVMuint32 offset);
+MVMuint64 MVM_predecode_allocated_size(MVMThreadContext *tc, MVMPredecoded *pd);
+void MVM_predecode_destroy(MVMThreadContext *tc, MVMPredecoded *pd);
@@ -220,6 +220,10 @@ struct MVMThreadContext {
      * the code */
     void **jit_return_address;
 
+    /* Number of JIT-compiled frames currently nested on the C stack through
+     * direct calls. */
+    MVMuint32 jit_direct_call_depth;
+
     /* This thread's current spesh log to write in to, if there curently is
      * one. */
     MVMSpeshLog *spesh_log;
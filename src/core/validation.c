@@ -56,6 +56,7 @@ typedef struct {
     MVMuint16         remaining_positionals;
     MVMuint32         remaining_jumplabels;
     MVMuint32         reg_type_var;
+    MVM_VECTOR_DECL(MVMuint32, fused);
 } Validator;
 
 
@@ -659,12 +660,124 @@ terminate_block:
 }
 
 
+/* Pairs of ops that are common enough in unspecialized code that saving the
+ * dispatch between them pays off. For a fused compare-and-branch, the branch
+ * must test the register the comparison wrote (uses_result), so that the
+ * superinstruction can branch on the value it just computed. */
+static const struct {
+    MVMuint16 first;
+    MVMuint16 second;
+    MVMuint16 fused;
+    MVMuint8  uses_result;
+} superinstructions[] = {
+    { MVM_OP_decont,       MVM_OP_istrue,   MVM_OP_sp_decont_istrue,      0 },
+    { MVM_OP_const_i64_16, MVM_OP_add_i,    MVM_OP_sp_const_i64_16_add_i, 0 },
+    { MVM_OP_getattr_o,    MVM_OP_decont,   MVM_OP_sp_getattr_o_decont,   0 },
+    { MVM_OP_eq_i,         MVM_OP_unless_i, MVM_OP_sp_eq_i_unless_i,      1 },
+    { MVM_OP_ne_i,         MVM_OP_unless_i, MVM_OP_sp_ne_i_unless_i,      1 },
+    { MVM_OP_lt_i,         MVM_OP_unless_i, MVM_OP_sp_lt_i_unless_i,      1 },
+    { MVM_OP_le_i,         MVM_OP_unless_i, MVM_OP_sp_le_i_unless_i,      1 },
+    { MVM_OP_gt_i,         MVM_OP_unless_i, MVM_OP_sp_gt_i_unless_i,      1 },
+    { MVM_OP_ge_i,         MVM_OP_unless_i, MVM_OP_sp_ge_i_unless_i,      1 },
+};
+
+#define NUM_SUPERINSTRUCTIONS (sizeof(superinstructions) / sizeof(superinstructions[0]))
+
+/* Replaces the opcode of the first op of each fusable pair with that of the
+ * superinstruction. Nothing else moves, so all offsets stay valid and a
+ * branch, handler or deopt into the second op still finds it intact. The
+ * bytecode is copied first if we do not own it yet. */
+static void fuse_superinstructions(Validator *val) {
+    MVMStaticFrameBody *fb = &val->frame->body;
+    MVMuint32 pos, next, i;
+
+    for (pos = 0; pos < val->bc_size; pos = next) {
+        MVMuint16 opcode = GET_UI16(val->bc_start, pos);
+        for (next = pos + 2; next < val->bc_size; next++)
+            if (val->labels[next] & MVM_BC_op_boundary)
+                break;
+        if (next >= val->bc_size)
+            break;
+        for (i = 0; i < NUM_SUPERINSTRUCTIONS; i++) {
+            if (superinstructions[i].first == opcode
+                    && superinstructions[i].second == GET_UI16(val->bc_start, next)
+                    && (!superinstructions[i].uses_result
+                        || GET_REG(val->bc_start, pos + 2) == GET_REG(val->bc_start, next + 2)))
+                break;
+        }
+        if (i == NUM_SUPERINSTRUCTIONS)
+            continue;
+        if (fb->bytecode == fb->orig_bytecode) {
+            fb->bytecode = MVM_malloc(val->bc_size);
+            memcpy(fb->bytecode, val->bc_start, val->bc_size);
+            val->bc_start = fb->bytecode;
+        }
+        *((MVMuint16 *)(val->bc_start + pos)) = superinstructions[i].fused;
+        MVM_VECTOR_PUSH(val->fused, pos);
+        /* The second op can not start another pair, it has to stay as is */
+        for (next = next + 2; next < val->bc_size; next++)
+            if (val->labels[next] & MVM_BC_op_boundary)
+                break;
+    }
+}
+
+/* Picks the shift used to index the inline cache by bytecode offset: the
+ * largest that still gives every findmeth and getattr_o a slot of its own,
+ * which is the floor of log2 of the smallest distance between two of them. */
+static void size_inline_cache(Validator *val) {
+    MVMuint32 pos, last = 0, min_gap = 0, seen = 0;
+    MVMuint8 shift = 0;
+
+    for (pos = 0; pos < val->bc_size; pos++) {
+        MVMuint16 opcode;
+        if (!(val->labels[pos] & MVM_BC_op_boundary))
+            continue;
+        opcode = GET_UI16(val->bc_start, pos);
+        if (opcode != MVM_OP_findmeth && opcode != MVM_OP_getattr_o)
+            continue;
+        if (seen && (min_gap == 0 || pos - last < min_gap))
+            min_gap = pos - last;
+        last = pos;
+        seen = 1;
+    }
+
+    if (!seen) {
+        val->frame->body.inline_cache_shift = 0;
+        return;
+    }
+    if (min_gap == 0) {
+        /* Just the one; everything fits in a single slot. */
+        val->frame->body.inline_cache_shift = 31;
+        return;
+    }
+    while (min_gap >> (shift + 1))
+        shift++;
+    val->frame->body.inline_cache_shift = shift;
+}
+
+/* Returns the op that a superinstruction was fused from, so that code reading
+ * unspecialized bytecode can treat it as if it had never been fused. */
+MVMuint16 MVM_validate_unfuse_op(MVMuint16 opcode) {
+    MVMuint32 i;
+    if (opcode < MVM_OP_sp_decont_istrue || opcode >= MVM_OP_EXT_BASE)
+        return opcode;
+    for (i = 0; i < NUM_SUPERINSTRUCTIONS; i++)
+        if (superinstructions[i].fused == opcode)
+            return superinstructions[i].first;
+    return opcode;
+}
+
 /* Validate that a static frame's bytecode is executable by the interpreter. */
 void MVM_validate_static_frame(MVMThreadContext *tc,
         MVMStaticFrame *static_frame) {
     MVMStaticFrameBody *fb = &static_frame->body;
     Validator val[1];
 
+#ifndef MVM_BIGENDIAN
+    if (MVM_validation_cache_apply(tc, static_frame))
+        return;
+#endif
+
     val->tc        = tc;
     val->cu        = fb->cu;
     val->frame     = static_frame;
@@ -687,6 +800,7 @@ void MVM_validate_static_frame(MVMThreadContext *tc,
     val->remaining_positionals = 0;
     val->remaining_jumplabels  = 0;
     val->reg_type_var          = 0;
+    MVM_VECTOR_INIT(val->fused, 0);
 
 #ifdef MVM_BIGENDIAN
     assert(fb->bytecode == fb->orig_bytecode);
@@ -728,6 +842,11 @@ void MVM_validate_static_frame(MVMThreadContext *tc,
     validate_branch_targets(val);
     validate_final_return(val);
 
+    size_inline_cache(val);
+    fuse_superinstructions(val);
+    MVM_validation_cache_record(tc, static_frame, val->fused, MVM_VECTOR_ELEMS(val->fused));
+
     /* Validation successful. Clear up instruction offsets. */
     MVM_free(val->labels);
+    MVM_VECTOR_DESTROY(val->fused);
 }
@@ -6,3 +6,4 @@ enum {
 };
 
 void MVM_validate_static_frame(MVMThreadContext *tc, MVMStaticFrame *static_frame);
+MVMuint16 MVM_validate_unfuse_op(MVMuint16 opcode);
@@ -0,0 +1,327 @@
+#include "moar.h"
+#include "platform/io.h"
+#include <sha1.h>
+
+/* The file starts with a header identifying the VM build, since fused ops
+ * and the validator's rules may differ between builds; then come the
+ * records, then the fused sites. */
+typedef struct {
+    char      magic[8];
+    MVMuint32 version;
+    MVMuint32 num_ops;
+    char      vm_version[32];
+    MVMuint32 num_records;
+    MVMuint32 num_fused;
+} CacheHeader;
+
+/* The number of ops this VM knows of. */
+static MVMuint32 num_ops(void) {
+    MVMuint32 n = 0;
+    while (MVM_op_get_op((unsigned short)n))
+        n++;
+    return n;
+}
+
+static void set_header(CacheHeader *header, MVMuint32 num_records, MVMuint32 num_fused) {
+    memset(header, 0, sizeof(CacheHeader));
+    memcpy(header->magic, MVM_VALIDATION_CACHE_MAGIC, 8);
+    header->version = MVM_VALIDATION_CACHE_VERSION;
+    header->num_ops = num_ops();
+    strncpy(header->vm_version, MVM_VERSION, sizeof(header->vm_version) - 1);
+    header->num_records = num_records;
+    header->num_fused   = num_fused;
+}
+
+static char * cache_path(MVMInstance *instance, MVMValidationCache *cache) {
+    size_t len  = strlen(instance->validation_cache_dir) + 1 + 40 + 5;
+    char  *path = MVM_malloc(len);
+    snprintf(path, len, "%s/%s.mvc", instance->validation_cache_dir, cache->key);
+    return path;
+}
+
+/* Reads the cached records for the cache's key, if there are any. */
+static void read_cache_file(MVMInstance *instance, MVMValidationCache *cache) {
+    CacheHeader expected, header;
+    char *path = cache_path(instance, cache);
+    FILE *fh   = MVM_platform_fopen(path, "rb");
+    MVM_free(path);
+    if (!fh)
+        return;
+
+    set_header(&expected, 0, 0);
+    if (fread(&header, sizeof(CacheHeader), 1, fh) == 1
+            && memcmp(header.magic, expected.magic, 8) == 0
+            && header.version == expected.version
+            && header.num_ops == expected.num_ops
+            && memcmp(header.vm_version, expected.vm_version, sizeof(header.vm_version)) == 0) {
+        MVM_VECTOR_ENSURE_SIZE(cache->records, header.num_records);
+        MVM_VECTOR_ENSURE_SIZE(cache->fused, header.num_fused);
+        if (fread(cache->records, sizeof(MVMValidationRecord), header.num_records, fh) == header.num_records
+                && fread(cache->fused, sizeof(MVMValidationFused), header.num_fused, fh) == header.num_fused) {
+            MVMuint32 i;
+            for (i = 0; i < header.num_records; i++)
+                if ((MVMuint64)cache->records[i].fused_start + cache->records[i].num_fused > header.num_fused)
+                    break;
+            if (i == header.num_records) {
+                cache->records_num = header.num_records;
+                cache->fused_num   = header.num_fused;
+                cache->num_loaded  = header.num_records;
+            }
+        }
+    }
+    fclose(fh);
+}
+
+/* Sets up the validation cache for a compilation unit loaded from a file,
+ * if caching is enabled, reading any results already on disk. Hashing the
+ * bytecode would touch every page of the mapped file, which for a large
+ * setting costs more than the validation saved; so the key comes from what
+ * stat said about the file: its device, inode, size and times, along with
+ * the offset of the compilation unit in it. */
+void MVM_validation_cache_load(MVMThreadContext *tc, MVMCompUnit *cu, const uv_stat_t *statbuf,
+        MVMuint64 offset) {
+    MVMInstance        *instance = tc->instance;
+    MVMValidationCache *cache;
+    SHA1Context         context;
+    MVMuint64           identity[8];
+    char                output[80];
+
+#ifdef MVM_BIGENDIAN
+    return;
+#endif
+    if (!instance->validation_cache_dir)
+        return;
+
+    identity[0] = statbuf->st_dev;
+    identity[1] = statbuf->st_ino;
+    identity[2] = statbuf->st_size;
+    identity[3] = (MVMuint64)statbuf->st_mtim.tv_sec;
+    identity[4] = (MVMuint64)statbuf->st_mtim.tv_nsec;
+    identity[5] = (MVMuint64)statbuf->st_ctim.tv_sec;
+    identity[6] = (MVMuint64)statbuf->st_ctim.tv_nsec;
+    identity[7] = offset;
+
+    cache = MVM_calloc(1, sizeof(MVMValidationCache));
+    SHA1Init(&context);
+    SHA1Update(&context, (unsigned char *)identity, sizeof(identity));
+    SHA1Final(&context, output);
+    memcpy(cache->key, output, 40);
+    cache->key[40] = '\0';
+    uv_mutex_init(&cache->mutex);
+    read_cache_file(instance, cache);
+
+    cu->body.validation_cache = cache;
+    uv_mutex_lock(&instance->mutex_validation_caches);
+    MVM_VECTOR_PUSH(instance->validation_caches, cache);
+    uv_mutex_unlock(&instance->mutex_validation_caches);
+}
+
+static MVMuint32 frame_offset(MVMStaticFrame *sf) {
+    return (MVMuint32)(sf->body.orig_bytecode - sf->body.cu->body.data_start);
+}
+
+/* Applies the cached validation result of a frame, if there is one, doing
+ * all that validation would have done to it. Returns zero if the frame
+ * still needs validating. */
+MVMint32 MVM_validation_cache_apply(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    MVMStaticFrameBody  *fb    = &sf->body;
+    MVMValidationCache  *cache = fb->cu->body.validation_cache;
+    MVMValidationRecord  record;
+    MVMStaticFrame      *outer;
+    MVMuint32 offset, i;
+    MVMint32  found = 0;
+    MVMint64  lo, hi;
+
+    if (!cache || fb->bytecode != fb->orig_bytecode)
+        return 0;
+
+    /* Find the frame's record, and check its fused sites are in the frame;
+     * only the loaded records are sorted. */
+    offset = frame_offset(sf);
+    uv_mutex_lock(&cache->mutex);
+    lo = 0;
+    hi = (MVMint64)cache->num_loaded - 1;
+    while (lo <= hi) {
+        MVMint64 mid = lo + (hi - lo) / 2;
+        if (cache->records[mid].bytecode_offset == offset) {
+            record = cache->records[mid];
+            found  = 1;
+            break;
+        }
+        if (cache->records[mid].bytecode_offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    for (i = 0; found && i < record.num_fused; i++)
+        if (cache->fused[record.fused_start + i].position + 2 > fb->bytecode_size)
+            found = 0;
+    uv_mutex_unlock(&cache->mutex);
+    if (!found)
+        return 0;
+
+    /* Checking lexical operands finishes deserializing the frames they are
+     * in; do that for all outers, as we don't know which those were. This
+     * takes other mutexes, so is done without holding the cache's. */
+    for (outer = fb->outer; outer; outer = outer->body.outer)
+        if (!outer->body.fully_deserialized)
+            MVM_bytecode_finish_frame(tc, outer->body.cu, outer, 0);
+
+    if (record.specializable)
+        fb->specializable = 1;
+    fb->inline_cache_shift = record.inline_cache_shift;
+    if (record.num_fused) {
+        MVMuint8 *bytecode = MVM_malloc(fb->bytecode_size);
+        memcpy(bytecode, fb->orig_bytecode, fb->bytecode_size);
+        uv_mutex_lock(&cache->mutex);
+        for (i = 0; i < record.num_fused; i++) {
+            MVMValidationFused *fused = &(cache->fused[record.fused_start + i]);
+            memcpy(bytecode + fused->position, &(fused->opcode), 2);
+        }
+        uv_mutex_unlock(&cache->mutex);
+        fb->bytecode = bytecode;
+    }
+    return 1;
+}
+
+/* Records the outcome of validating a frame, to be written out later. */
+void MVM_validation_cache_record(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMuint32 *fused_positions, MVMuint32 num_fused) {
+    MVMStaticFrameBody  *fb    = &sf->body;
+    MVMValidationCache  *cache = fb->cu->body.validation_cache;
+    MVMValidationRecord  record;
+    MVMuint32 i;
+
+    if (!cache || fb->orig_bytecode < fb->cu->body.data_start
+            || fb->orig_bytecode >= fb->cu->body.data_start + fb->cu->body.data_size)
+        return;
+
+    record.bytecode_offset    = frame_offset(sf);
+    record.num_fused          = num_fused;
+    record.specializable      = fb->specializable;
+    record.inline_cache_shift = fb->inline_cache_shift;
+    record.padding            = 0;
+    uv_mutex_lock(&cache->mutex);
+    record.fused_start        = (MVMuint32)MVM_VECTOR_ELEMS(cache->fused);
+    for (i = 0; i < num_fused; i++) {
+        MVMValidationFused fused;
+        fused.position = fused_positions[i];
+        memcpy(&(fused.opcode), fb->bytecode + fused_positions[i], 2);
+        fused.padding  = 0;
+        MVM_VECTOR_PUSH(cache->fused, fused);
+    }
+    MVM_VECTOR_PUSH(cache->records, record);
+    cache->dirty = 1;
+    uv_mutex_unlock(&cache->mutex);
+}
+
+static int cmp_records(const void *a, const void *b) {
+    MVMuint32 x = ((MVMValidationRecord *)a)->bytecode_offset;
+    MVMuint32 y = ((MVMValidationRecord *)b)->bytecode_offset;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/* Writes all records of a cache to disk, sorted and without duplicates. To
+ * not leave a half-written file for another process to pick up, it goes to
+ * a temporary file that is then renamed into place. The caller holds the
+ * cache's mutex. */
+static void write_cache_file(MVMInstance *instance, MVMValidationCache *cache) {
+    CacheHeader header;
+    size_t      num_records = 0, i;
+    char       *path, *tmp_path;
+    size_t      tmp_len;
+    FILE       *fh;
+
+    qsort(cache->records, MVM_VECTOR_ELEMS(cache->records), sizeof(MVMValidationRecord), cmp_records);
+    for (i = 0; i < MVM_VECTOR_ELEMS(cache->records); i++)
+        if (!num_records || cache->records[num_records - 1].bytecode_offset != cache->records[i].bytecode_offset)
+            cache->records[num_records++] = cache->records[i];
+    cache->records_num = num_records;
+    cache->num_loaded  = num_records;
+
+    path     = cache_path(instance, cache);
+    tmp_len  = strlen(path) + 32;
+    tmp_path = MVM_malloc(tmp_len);
+    snprintf(tmp_path, tmp_len, "%s.%"PRIu64, path, (MVMuint64)MVM_proc_getpid(instance->main_thread));
+    if ((fh = MVM_platform_fopen(tmp_path, "wb"))) {
+        int ok;
+        set_header(&header, (MVMuint32)num_records, (MVMuint32)MVM_VECTOR_ELEMS(cache->fused));
+        ok = fwrite(&header, sizeof(CacheHeader), 1, fh) == 1
+            && fwrite(cache->records, sizeof(MVMValidationRecord), num_records, fh) == num_records
+            && fwrite(cache->fused, sizeof(MVMValidationFused), MVM_VECTOR_ELEMS(cache->fused), fh)
+                == MVM_VECTOR_ELEMS(cache->fused);
+        if (fclose(fh) != 0 || !ok || rename(tmp_path, path) != 0)
+            remove(tmp_path);
+    }
+    MVM_free(tmp_path);
+    MVM_free(path);
+    cache->dirty = 0;
+}
+
+static void free_cache(MVMValidationCache *cache) {
+    uv_mutex_destroy(&cache->mutex);
+    MVM_VECTOR_DESTROY(cache->records);
+    MVM_VECTOR_DESTROY(cache->fused);
+    MVM_free(cache);
+}
+
+/* Called when a compilation unit is freed. Its cache is freed too, unless
+ * there are records to write, in which case it stays in the instance list
+ * until the next flush writes and frees it. */
+void MVM_validation_cache_release(MVMThreadContext *tc, MVMValidationCache *cache) {
+    MVMInstance *instance = tc->instance;
+    size_t i;
+    uv_mutex_lock(&instance->mutex_validation_caches);
+    uv_mutex_lock(&cache->mutex);
+    cache->released = 1;
+    if (cache->dirty) {
+        uv_mutex_unlock(&cache->mutex);
+        uv_mutex_unlock(&instance->mutex_validation_caches);
+        return;
+    }
+    uv_mutex_unlock(&cache->mutex);
+    for (i = 0; i < MVM_VECTOR_ELEMS(instance->validation_caches); i++) {
+        if (instance->validation_caches[i] == cache) {
+            instance->validation_caches[i] = instance->validation_caches[--instance->validation_caches_num];
+            break;
+        }
+    }
+    uv_mutex_unlock(&instance->mutex_validation_caches);
+    free_cache(cache);
+}
+
+/* Writes out all caches with new records, and frees those whose compilation
+ * unit is gone; used when the VM exits, perhaps while other threads are
+ * still validating frames. */
+void MVM_validation_cache_flush(MVMInstance *instance) {
+    size_t i = 0;
+    if (!instance->validation_cache_dir)
+        return;
+    uv_mutex_lock(&instance->mutex_validation_caches);
+    while (i < MVM_VECTOR_ELEMS(instance->validation_caches)) {
+        MVMValidationCache *cache = instance->validation_caches[i];
+        MVMuint8 released;
+        uv_mutex_lock(&cache->mutex);
+        if (cache->dirty)
+            write_cache_file(instance, cache);
+        released = cache->released;
+        uv_mutex_unlock(&cache->mutex);
+        if (released) {
+            instance->validation_caches[i] = instance->validation_caches[--instance->validation_caches_num];
+            free_cache(cache);
+        }
+        else {
+            i++;
+        }
+    }
+    uv_mutex_unlock(&instance->mutex_validation_caches);
+}
+
+/* Writes out and frees all caches left when the instance is destroyed. */
+void MVM_validation_cache_teardown(MVMInstance *instance) {
+    size_t i;
+    MVM_validation_cache_flush(instance);
+    for (i = 0; i < MVM_VECTOR_ELEMS(instance->validation_caches); i++)
+        free_cache(instance->validation_caches[i]);
+    MVM_VECTOR_DESTROY(instance->validation_caches);
+}
@@ -0,0 +1,55 @@
+/* An on-disk cache of bytecode validation results, keyed by the identity of
+ * the bytecode file and the VM build. A frame with a cached result skips
+ * validation entirely, so only point MVM_VALIDATION_CACHE at a directory
+ * that holds nothing but trusted caches. */
+
+#define MVM_VALIDATION_CACHE_MAGIC   "MVMVCACH"
+#define MVM_VALIDATION_CACHE_VERSION 1
+
+/* What validating a frame found out about it. Fused sites are the offsets
+ * of ops replaced by a superinstruction, along with that superinstruction. */
+struct MVMValidationRecord {
+    MVMuint32 bytecode_offset;
+    MVMuint32 fused_start;
+    MVMuint32 num_fused;
+    MVMuint8  specializable;
+    MVMuint8  inline_cache_shift;
+    MVMuint16 padding;
+};
+struct MVMValidationFused {
+    MVMuint32 position;
+    MVMuint16 opcode;
+    MVMuint16 padding;
+};
+
+/* The cache of one compilation unit. Frames are validated on any thread,
+ * and caches are written out from the instance list at exit, so all but the
+ * key is only touched while holding the cache's mutex. A cache outlives its
+ * compilation unit if it still has records to write, so that the GC never
+ * does file I/O. */
+struct MVMValidationCache {
+    /* Hex SHA-1 of the file's identity. */
+    char key[41];
+
+    uv_mutex_t mutex;
+
+    /* Records, of which the first num_loaded came from disk and are sorted
+     * by bytecode offset. */
+    MVM_VECTOR_DECL(MVMValidationRecord, records);
+    size_t num_loaded;
+    MVM_VECTOR_DECL(MVMValidationFused, fused);
+
+    /* Whether there are records not on disk yet, and whether the
+     * compilation unit was freed. */
+    MVMuint8 dirty;
+    MVMuint8 released;
+};
+
+void MVM_validation_cache_load(MVMThreadContext *tc, MVMCompUnit *cu, const uv_stat_t *statbuf,
+    MVMuint64 offset);
+MVMint32 MVM_validation_cache_apply(MVMThreadContext *tc, MVMStaticFrame *sf);
+void MVM_validation_cache_record(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMuint32 *fused_positions, MVMuint32 num_fused);
+void MVM_validation_cache_release(MVMThreadContext *tc, MVMValidationCache *cache);
+void MVM_validation_cache_flush(MVMInstance *instance);
+void MVM_validation_cache_teardown(MVMInstance *instance);
@@ -190,6 +190,7 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
             "Thread %d run %d : Co-ordinator handling fixed-size allocator safepoint frees\n");
         MVM_fixed_size_safepoint(tc, tc->instance->fsa);
         MVM_alloc_safepoint(tc);
+        MVM_jit_code_safepoint(tc);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
             "Thread %d run %d : Co-ordinator signalling in-trays clear\n");
         uv_mutex_lock(&tc->instance->mutex_gc_orchestrate);
@@ -521,6 +522,8 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
 
         /* Decide if it will be a full collection. */
         tc->instance->gc_full_collect = is_full_collection(tc);
+        if (tc->instance->gc_full_collect)
+            MVM_incr(&tc->instance->gc_full_seq_number);
 
         MVM_telemetry_timestamp(tc, "won the gc starting race");
 
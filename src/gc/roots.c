@@ -91,6 +91,11 @@ void MVM_gc_root_add_instance_roots_to_worklist(MVMThreadContext *tc, MVMGCWorkl
     add_collectable(tc, worklist, snapshot, tc->instance->spesh_queue,
         "Specialization log queue");
 
+    add_collectable(tc, worklist, snapshot, tc->instance->deserialize_threads,
+        "Deserialization helper threads");
+    add_collectable(tc, worklist, snapshot, tc->instance->deserialize_queue,
+        "Deserialization helper queue");
+
     if (worklist)
         MVM_spesh_plan_gc_mark(tc, tc->instance->spesh_plan, worklist);
 
@@ -433,6 +438,12 @@ void MVM_gc_root_add_frame_roots_to_worklist(MVMThreadContext *tc, MVMGCWorklist
         MVM_gc_worklist_add(tc, worklist, &e->exit_handler_result);
     }
 
+    /* If the frame is running an evicted specialization, note that it is
+     * still in use, so its memory is not released from under it. */
+    if (cur_frame->spesh_cand && cur_frame->spesh_cand->eviction_state)
+        cur_frame->spesh_cand->last_seen_full_gc =
+            (MVMuint32)MVM_load(&tc->instance->gc_full_seq_number);
+
     /* Scan the registers. */
     MVM_gc_root_add_frame_registers_to_worklist(tc, worklist, cur_frame);
     scan_lexicals(tc, worklist, cur_frame);
@@ -1232,8 +1232,10 @@ MVMint64 MVM_proc_fork(MVMThreadContext *tc) {
 
     /* Stop and join the system threads */
     MVM_spesh_worker_stop(tc);
+    MVM_deserialize_worker_stop(tc);
     MVM_io_eventloop_stop(tc);
     MVM_spesh_worker_join(tc);
+    MVM_deserialize_worker_join(tc);
     MVM_io_eventloop_join(tc);
     /* Allow MVM_io_eventloop_start to restart the thread if necessary */
     instance->event_loop_thread = NULL;
@@ -1258,6 +1260,7 @@ MVMint64 MVM_proc_fork(MVMThreadContext *tc) {
     uv_mutex_unlock(&instance->mutex_threads);
     /* Without the mutex_event_loop being held, this might race */
     MVM_spesh_worker_start(tc);
+    MVM_deserialize_worker_start(tc);
 
     /* However, locks are nonrecursive, so unlocking is needed prior to
      * restarting the event loop */
@@ -44,8 +44,8 @@ static void debug_spill_map(MVMThreadContext *tc, MVMJitCompiler *cl) {
 }
 
 void MVM_jit_compiler_init(MVMThreadContext *tc, MVMJitCompiler *cl, MVMJitGraph *jg) {
-    /* Create dasm state */
-    dasm_init(cl, 2);
+    /* Create dasm state; three sections (code, cold, data) */
+    dasm_init(cl, 3);
     dasm_setupglobal(cl, cl->dasm_globals, MVM_JIT_MAX_GLOBALS);
     dasm_setup(cl, MVM_jit_actions());
 
@@ -140,6 +140,8 @@ MVMJitCode * MVM_jit_compile_graph(MVMThreadContext *tc, MVMJitGraph *jg) {
         MVM_free(file_location);
         MVM_free(frame_name);
     }
+    if (tc->instance->jit_perf_dump && jg->sg->sf && code)
+        MVM_jit_perf_dump_code(tc, jg, code);
 #endif
 
     /* Logging for insight */
@@ -243,6 +245,75 @@ MVMJitCode * MVM_jit_compiler_assemble(MVMThreadContext *tc, MVMJitCompiler *cl,
     return code;
 }
 
+/* Compiles an argument guard tree into a standalone function. Returns NULL
+ * if the code could not be assembled; the tree interpreter is used then. */
+MVMSpeshArgGuardJitFunc MVM_jit_compile_arg_guard(MVMThreadContext *tc, MVMSpeshArgGuard *ag,
+                                                  size_t *size) {
+    MVMJitCompiler cl;
+    MVMint32 dasm_error = 0;
+    size_t codesize;
+    char *memory;
+
+    memset(&cl, 0, sizeof(MVMJitCompiler));
+    dasm_init(&cl, 3);
+    dasm_setupglobal(&cl, cl.dasm_globals, MVM_JIT_MAX_GLOBALS);
+    dasm_setup(&cl, MVM_jit_actions());
+    /* one label per node, plus the no-match exit */
+    dasm_growpc(&cl, ag->used_nodes + 1);
+
+    MVM_jit_emit_arg_guard(tc, &cl, ag);
+
+    if ((dasm_error = dasm_link(&cl, &codesize)) != 0) {
+        if (tc->instance->jit_debug_enabled)
+            fprintf(stderr, "DynASM could not link arg guard, error: %d\n", dasm_error);
+        dasm_free(&cl);
+        return NULL;
+    }
+    memory = MVM_platform_alloc_pages(codesize, MVM_PAGE_READ|MVM_PAGE_WRITE);
+    if ((dasm_error = dasm_encode(&cl, memory)) != 0) {
+        if (tc->instance->jit_debug_enabled)
+            fprintf(stderr, "DynASM could not encode arg guard, error: %d\n", dasm_error);
+        MVM_platform_free_pages(memory, codesize);
+        dasm_free(&cl);
+        return NULL;
+    }
+    dasm_free(&cl);
+    if (!MVM_platform_set_page_mode(memory, codesize, MVM_PAGE_READ|MVM_PAGE_EXEC)) {
+        if (tc->instance->jit_debug_enabled)
+            fprintf(stderr, "JIT: Impossible to mark arg guard read/executable");
+        MVM_platform_free_pages(memory, codesize);
+        return NULL;
+    }
+    *size = codesize;
+    return (MVMSpeshArgGuardJitFunc)memory;
+}
+
+/* Frees a region of compiled code. If `safe` is non-zero, then another
+ * thread may still be executing it, and it is queued to be freed at the
+ * next GC safepoint instead. */
+void MVM_jit_free_code(MVMThreadContext *tc, void *memory, size_t size, MVMuint32 safe) {
+    if (safe) {
+        MVMJitFreeAtSafepoint entry;
+        entry.memory = memory;
+        entry.size   = size;
+        uv_mutex_lock(&tc->instance->mutex_free_at_safepoint);
+        MVM_VECTOR_PUSH(tc->instance->jit_free_at_safepoint, entry);
+        uv_mutex_unlock(&tc->instance->mutex_free_at_safepoint);
+    }
+    else {
+        MVM_platform_free_pages(memory, size);
+    }
+}
+
+/* Frees code queued by MVM_jit_free_code. Called by the GC co-ordinator, so
+ * there's no need to acquire the mutex. */
+void MVM_jit_code_safepoint(MVMThreadContext *tc) {
+    while (MVM_VECTOR_ELEMS(tc->instance->jit_free_at_safepoint)) {
+        MVMJitFreeAtSafepoint entry = MVM_VECTOR_POP(tc->instance->jit_free_at_safepoint);
+        MVM_platform_free_pages(entry.memory, entry.size);
+    }
+}
+
 MVMJitCode* MVM_jit_code_copy(MVMThreadContext *tc, MVMJitCode * const code) {
     AO_fetch_and_add1(&code->ref_cnt);
     return code;
@@ -326,6 +397,9 @@ void MVM_jit_compile_expr_tree(MVMThreadContext *tc, MVMJitCompiler *compiler, M
     /* Second stage, allocate registers */
     MVM_jit_linear_scan_allocate(tc, compiler, list);
 
+    /* Clean up redundant moves, reloads and tests */
+    MVM_jit_tile_list_peephole(tc, list);
+
     /* Allocate sufficient space for the new internal labels */
     dasm_growpc(compiler, compiler->label_offset);
 
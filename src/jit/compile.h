@@ -34,6 +34,11 @@ MVMJitCode* MVM_jit_compile_graph(MVMThreadContext *tc, MVMJitGraph *graph);
 MVMJitCode* MVM_jit_code_copy(MVMThreadContext *tc, MVMJitCode * const code);
 void MVM_jit_code_destroy(MVMThreadContext *tc, MVMJitCode *code);
 
+MVMSpeshArgGuardJitFunc MVM_jit_compile_arg_guard(MVMThreadContext *tc, MVMSpeshArgGuard *ag,
+                                                  size_t *size);
+void MVM_jit_free_code(MVMThreadContext *tc, void *memory, size_t size, MVMuint32 safe);
+void MVM_jit_code_safepoint(MVMThreadContext *tc);
+
 /* Peseudotile compile functions */
 void MVM_jit_compile_label(MVMThreadContext *tc, MVMJitCompiler *compiler,
                            MVMJitTile *tile, MVMJitExprTree *tree);
@@ -2,6 +2,12 @@
 #include "jit/internal.h"
 #include "platform/io.h"
 
+#if linux
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 void MVM_jit_dump_bytecode(MVMThreadContext *tc, MVMJitCode *code) {
     char filename[1024];
     FILE * dump;
@@ -134,3 +140,293 @@ void MVM_jit_dump_tile_list(MVMThreadContext *tc, MVMJitTileList *list) {
                  "====================\n\n");
 
 }
+
+/* Writer for the perf 'jitdump' format (tools/perf/Documentation/jitdump
+ * -specification.txt in the linux tree). Unlike the perf map, it carries the
+ * code bytes, so that 'perf inject --jit' can produce an ELF image per frame
+ * for annotation, together with line numbers and unwinding tables. */
+#define JITDUMP_MAGIC       0x4A695444
+#define JITDUMP_VERSION     1
+#define JITDUMP_ELF_X86_64  62
+
+#define JIT_CODE_LOAD           0
+#define JIT_CODE_CLOSE          3
+#define JIT_CODE_DEBUG_INFO     2
+#define JIT_CODE_UNWINDING_INFO 4
+
+#define JITDUMP_ALIGN(x) (((x) + 7) & ~((size_t)7))
+
+typedef struct {
+    MVM_VECTOR_DECL(char, data);
+} JitDumpBuffer;
+
+static void buf_write(JitDumpBuffer *buf, const void *data, size_t size) {
+    MVM_VECTOR_ENSURE_SPACE(buf->data, size);
+    memcpy(buf->data + buf->data_num, data, size);
+    buf->data_num += size;
+}
+
+static void buf_u8(JitDumpBuffer *buf, MVMuint8 v) {
+    buf_write(buf, &v, sizeof(v));
+}
+static void buf_u32(JitDumpBuffer *buf, MVMuint32 v) {
+    buf_write(buf, &v, sizeof(v));
+}
+static void buf_u64(JitDumpBuffer *buf, MVMuint64 v) {
+    buf_write(buf, &v, sizeof(v));
+}
+
+static void patch_u32(JitDumpBuffer *buf, size_t at, MVMuint32 v) {
+    memcpy(buf->data + at, &v, sizeof(v));
+}
+static void patch_u64(JitDumpBuffer *buf, size_t at, MVMuint64 v) {
+    memcpy(buf->data + at, &v, sizeof(v));
+}
+
+static void buf_pad(JitDumpBuffer *buf, size_t to) {
+    while (buf->data_num < to)
+        buf_u8(buf, 0);
+}
+
+/* All records start with the same prefix; the total size is patched in by
+ * record_end, which also pads the record to 8 bytes */
+static size_t record_start(JitDumpBuffer *buf, MVMuint32 id) {
+    size_t start = buf->data_num;
+    buf_u32(buf, id);
+    buf_u32(buf, 0);
+    buf_u64(buf, uv_hrtime());
+    return start;
+}
+
+static void record_end(JitDumpBuffer *buf, size_t start) {
+    buf_pad(buf, start + JITDUMP_ALIGN(buf->data_num - start));
+    patch_u32(buf, start + 4, buf->data_num - start);
+}
+
+static MVMuint32 thread_id(void) {
+#if linux
+    return (MVMuint32)syscall(SYS_gettid);
+#else
+    return 0;
+#endif
+}
+
+void MVM_jit_perf_dump_open(MVMInstance *instance) {
+#if linux
+    char filename[64];
+    MVMuint64 pid = MVM_proc_getpid(NULL);
+    JitDumpBuffer buf;
+    FILE *f;
+    void *marker;
+
+    snprintf(filename, sizeof(filename), "/tmp/jit-%"PRIu64".dump", pid);
+    /* Opened for reading as well, as we need to map it below */
+    f = MVM_platform_fopen(filename, "w+");
+    if (!f)
+        return;
+
+    MVM_VECTOR_INIT(buf.data, 64);
+    buf_u32(&buf, JITDUMP_MAGIC);
+    buf_u32(&buf, JITDUMP_VERSION);
+    buf_u32(&buf, 40);
+    buf_u32(&buf, JITDUMP_ELF_X86_64);
+    buf_u32(&buf, 0);
+    buf_u32(&buf, (MVMuint32)pid);
+    buf_u64(&buf, uv_hrtime());
+    buf_u64(&buf, 0);
+    fwrite(buf.data, 1, buf.data_num, f);
+    fflush(f);
+    MVM_VECTOR_DESTROY(buf.data);
+
+    /* perf record finds the dump by its executable mapping */
+    marker = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ|PROT_EXEC, MAP_PRIVATE,
+                  fileno(f), 0);
+    if (marker == MAP_FAILED) {
+        fclose(f);
+        return;
+    }
+    instance->jit_perf_dump        = f;
+    instance->jit_perf_dump_marker = marker;
+    instance->jit_perf_dump_index  = 0;
+#endif
+}
+
+void MVM_jit_perf_dump_close(MVMInstance *instance) {
+#if linux
+    JitDumpBuffer buf;
+    size_t start;
+    if (!instance->jit_perf_dump)
+        return;
+    MVM_VECTOR_INIT(buf.data, 16);
+    start = record_start(&buf, JIT_CODE_CLOSE);
+    record_end(&buf, start);
+    fwrite(buf.data, 1, buf.data_num, instance->jit_perf_dump);
+    MVM_VECTOR_DESTROY(buf.data);
+    munmap(instance->jit_perf_dump_marker, sysconf(_SC_PAGESIZE));
+    fclose(instance->jit_perf_dump);
+    instance->jit_perf_dump = NULL;
+#endif
+}
+
+/* Finds the compunit that the code at addr belongs to, which is that of the
+ * innermost inline covering it, if any. */
+static MVMCompUnit * cu_for_address(MVMThreadContext *tc, MVMJitGraph *jg,
+                                    MVMJitCode *code, char *addr) {
+    MVMSpeshGraph *sg = jg->sg;
+    MVMCompUnit *cu = sg->sf->body.cu;
+    char *best_start = NULL, *best_end = NULL;
+    MVMuint32 i;
+    for (i = 0; i < code->num_inlines; i++) {
+        char *start = code->labels[code->inlines[i].start_label];
+        char *end   = code->labels[code->inlines[i].end_label];
+        if (addr < start || addr >= end)
+            continue;
+        if (start > best_start || (start == best_start && end < best_end)) {
+            best_start = start;
+            best_end   = end;
+            cu         = sg->inlines[i].sf->body.cu;
+        }
+    }
+    return cu;
+}
+
+static void write_debug_info(MVMThreadContext *tc, JitDumpBuffer *buf,
+                             MVMJitGraph *jg, MVMJitCode *code) {
+    size_t start = record_start(buf, JIT_CODE_DEBUG_INFO);
+    size_t nr_entry_at;
+    MVMuint32 i, nr_entry = 0;
+
+    buf_u64(buf, (MVMuint64)(uintptr_t)code->func_ptr);
+    nr_entry_at = buf->data_num;
+    buf_u64(buf, 0);
+    for (i = 0; i < jg->lines_num; i++) {
+        MVMJitLineNumber *line = jg->lines + i;
+        char *addr = code->labels[line->label];
+        MVMCompUnit *cu;
+        char *filename;
+        /* Only the last of several lines that generated no code counts */
+        if (i + 1 < jg->lines_num && code->labels[jg->lines[i + 1].label] == addr)
+            continue;
+        cu = cu_for_address(tc, jg, code, addr);
+        filename = line->filename_idx < cu->body.num_strings
+            ? MVM_string_utf8_encode_C_string(tc, MVM_cu_string(tc, cu, line->filename_idx))
+            : NULL;
+        buf_u64(buf, (MVMuint64)(uintptr_t)addr);
+        buf_u32(buf, line->line_number);
+        buf_u32(buf, 0);
+        if (filename) {
+            buf_write(buf, filename, strlen(filename) + 1);
+            MVM_free(filename);
+        }
+        else {
+            buf_write(buf, "<unknown>", sizeof("<unknown>"));
+        }
+        nr_entry++;
+    }
+    patch_u64(buf, nr_entry_at, nr_entry);
+    record_end(buf, start);
+}
+
+/* The unwinding info is an .eh_frame with a single FDE followed by an
+ * .eh_frame_hdr, which perf places directly after the code (aligned to 8
+ * bytes), so all pointers are relative to that layout. The FDE describes the
+ * prologue, 'push rbp; mov rbp, rsp', after which the frame is addressed from
+ * rbp until the final 'ret'. */
+static void write_unwinding_info(MVMThreadContext *tc, JitDumpBuffer *buf, MVMJitCode *code) {
+    size_t start = record_start(buf, JIT_CODE_UNWINDING_INFO);
+    size_t sizes_at, eh_frame, cie, fde, hdr;
+    MVMuint64 cie_size, eh_frame_size, hdr_size, text_size = JITDUMP_ALIGN(code->size);
+
+    sizes_at = buf->data_num;
+    buf_u64(buf, 0); /* unwinding_size */
+    buf_u64(buf, 0); /* eh_frame_hdr_size */
+    buf_u64(buf, 0); /* mapped_size */
+
+    /* CIE */
+    eh_frame = cie = buf->data_num;
+    buf_u32(buf, 0);    /* length */
+    buf_u32(buf, 0);    /* CIE id */
+    buf_u8(buf, 1);     /* version */
+    buf_write(buf, "zR", 3);
+    buf_u8(buf, 1);     /* code alignment */
+    buf_u8(buf, 0x78);  /* data alignment, -8 */
+    buf_u8(buf, 16);    /* return address register, rip */
+    buf_u8(buf, 1);     /* augmentation size */
+    buf_u8(buf, 0x1B);  /* FDE pointers are pc-relative sdata4 */
+    buf_u8(buf, 0x0C); buf_u8(buf, 7); buf_u8(buf, 8); /* def_cfa rsp+8 */
+    buf_u8(buf, 0x90); buf_u8(buf, 1); /* rip at cfa-8 */
+    buf_pad(buf, cie + JITDUMP_ALIGN(buf->data_num - cie));
+    cie_size = buf->data_num - cie;
+    patch_u32(buf, cie, cie_size - 4);
+
+    /* FDE */
+    fde = buf->data_num;
+    buf_u32(buf, 0);
+    buf_u32(buf, fde + 4 - cie);
+    buf_u32(buf, (MVMuint32)-(MVMint64)(text_size + cie_size + 8));
+    buf_u32(buf, code->size);
+    buf_u8(buf, 0);     /* augmentation size */
+    buf_u8(buf, 0x41);  /* advance 1, past push rbp */
+    buf_u8(buf, 0x0E); buf_u8(buf, 16); /* def_cfa_offset 16 */
+    buf_u8(buf, 0x86); buf_u8(buf, 2);  /* rbp at cfa-16 */
+    buf_u8(buf, 0x43);  /* advance 3, past mov rbp, rsp */
+    buf_u8(buf, 0x0D); buf_u8(buf, 6);  /* def_cfa_register rbp */
+    buf_pad(buf, fde + JITDUMP_ALIGN(buf->data_num - fde));
+    patch_u32(buf, fde, buf->data_num - fde - 4);
+
+    /* terminator */
+    buf_u32(buf, 0);
+    eh_frame_size = buf->data_num - eh_frame;
+
+    /* .eh_frame_hdr */
+    hdr = buf->data_num;
+    buf_u8(buf, 1);     /* version */
+    buf_u8(buf, 0x1B);  /* eh_frame_ptr, pc-relative sdata4 */
+    buf_u8(buf, 0x03);  /* fde_count, udata4 */
+    buf_u8(buf, 0x3B);  /* table, datarel sdata4 */
+    buf_u32(buf, (MVMuint32)-(MVMint64)(eh_frame_size + 4));
+    buf_u32(buf, 1);
+    buf_u32(buf, (MVMuint32)-(MVMint64)(text_size + eh_frame_size));
+    buf_u32(buf, (MVMuint32)-(MVMint64)(eh_frame_size - cie_size));
+    hdr_size = buf->data_num - hdr;
+
+    patch_u64(buf, sizes_at, eh_frame_size + hdr_size);
+    patch_u64(buf, sizes_at + 8, hdr_size);
+    patch_u64(buf, sizes_at + 16, JITDUMP_ALIGN(eh_frame_size + hdr_size));
+    record_end(buf, start);
+}
+
+/* Writes a frame's code to the jitdump. Debug and unwinding info must precede
+ * the load record of the code they describe. */
+void MVM_jit_perf_dump_code(MVMThreadContext *tc, MVMJitGraph *jg, MVMJitCode *code) {
+    MVMStaticFrame *sf = jg->sg->sf;
+    JitDumpBuffer buf;
+    size_t start;
+    char *file_location = MVM_staticframe_file_location(tc, sf);
+    char *frame_name = MVM_string_utf8_encode_C_string(tc, sf->body.name);
+
+    MVM_VECTOR_INIT(buf.data, 256 + code->size);
+    if (jg->lines_num > 0)
+        write_debug_info(tc, &buf, jg, code);
+    write_unwinding_info(tc, &buf, code);
+
+    start = record_start(&buf, JIT_CODE_LOAD);
+    buf_u32(&buf, (MVMuint32)MVM_proc_getpid(NULL));
+    buf_u32(&buf, thread_id());
+    buf_u64(&buf, (MVMuint64)(uintptr_t)code->func_ptr);
+    buf_u64(&buf, (MVMuint64)(uintptr_t)code->func_ptr);
+    buf_u64(&buf, code->size);
+    buf_u64(&buf, tc->instance->jit_perf_dump_index++);
+    buf_write(&buf, frame_name, strlen(frame_name));
+    buf_u8(&buf, '(');
+    buf_write(&buf, file_location, strlen(file_location));
+    buf_write(&buf, ")", 2);
+    buf_write(&buf, code->func_ptr, code->size);
+    record_end(&buf, start);
+
+    fwrite(buf.data, 1, buf.data_num, tc->instance->jit_perf_dump);
+    fflush(tc->instance->jit_perf_dump);
+    MVM_VECTOR_DESTROY(buf.data);
+    MVM_free(file_location);
+    MVM_free(frame_name);
+}
@@ -2,6 +2,10 @@ void MVM_jit_dump_bytecode(MVMThreadContext *tc, MVMJitCode *code);
 void MVM_jit_dump_expr_tree(MVMThreadContext *tc, MVMJitExprTree *tree);
 void MVM_jit_dump_tile_list(MVMThreadContext *tc, MVMJitTileList *list);
 
+void MVM_jit_perf_dump_open(MVMInstance *instance);
+void MVM_jit_perf_dump_code(MVMThreadContext *tc, MVMJitGraph *jg, MVMJitCode *code);
+void MVM_jit_perf_dump_close(MVMInstance *instance);
+
 MVM_STATIC_INLINE MVMint32 MVM_jit_debug_enabled(MVMThreadContext *tc) {
     return MVM_spesh_debug_enabled(tc) && tc->instance->jit_debug_enabled;
 }
@@ -9,3 +13,7 @@ MVM_STATIC_INLINE MVMint32 MVM_jit_debug_enabled(MVMThreadContext *tc) {
 MVM_STATIC_INLINE MVMint32 MVM_jit_bytecode_dump_enabled(MVMThreadContext *tc) {
     return tc->instance->jit_bytecode_dir != NULL;
 }
+
+MVM_STATIC_INLINE MVMint32 MVM_jit_perf_dump_enabled(MVMThreadContext *tc) {
+    return tc->instance->jit_perf_dump != NULL;
+}
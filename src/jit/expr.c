@@ -640,6 +640,329 @@ void MVM_jit_expr_tree_analyze(MVMThreadContext *tc, MVMJitExprTree *tree) {
 
 
 
+/* Value numbering, constant folding and algebraic simplification of the
+ * analyzed tree. Templates are applied per instruction, so the same address
+ * computations and loads (the current frame, a STable, a REPR body) are
+ * repeated throughout a tree; numbering the nodes lets them be computed just
+ * once.
+ *
+ * Only nodes that are evaluated unconditionally are recorded for reuse, and a
+ * recorded node is only reused as long as no barrier intervened: loads are
+ * invalidated by stores, and all values by calls and guards (which may
+ * change memory and would force the value to be spilled) and marks (which
+ * may be jump targets, where earlier values are not available). */
+struct TreeOptimizer {
+    MVMint32  *replace;
+    MVMint32  *table;
+    MVMuint32  table_mask;
+    /* barrier counts at the time each node was recorded */
+    MVMuint32 *barrier_at;
+    MVMuint32 *memory_at;
+    MVMuint32  barrier, memory;
+    MVMuint32  cond_depth;
+};
+
+enum {
+    VALUE_NONE,
+    VALUE_PURE,
+    VALUE_LOAD
+};
+
+static MVMint32 value_kind(MVMint32 op) {
+    switch (op) {
+    case MVM_JIT_TC:
+    case MVM_JIT_CU:
+    case MVM_JIT_LOCAL:
+    case MVM_JIT_STACK:
+    case MVM_JIT_CONST_PTR:
+    case MVM_JIT_CONST_LARGE:
+    case MVM_JIT_CONST_NUM:
+    case MVM_JIT_ADDR:
+    case MVM_JIT_IDX:
+    case MVM_JIT_ADD:
+    case MVM_JIT_SUB:
+    case MVM_JIT_MUL:
+    case MVM_JIT_AND:
+    case MVM_JIT_OR:
+    case MVM_JIT_XOR:
+    case MVM_JIT_NOT:
+    case MVM_JIT_SCAST:
+    case MVM_JIT_UCAST:
+        return VALUE_PURE;
+    case MVM_JIT_LOAD:
+    case MVM_JIT_LOAD_NUM:
+        return VALUE_LOAD;
+    default:
+        /* Small CONST nodes are not numbered, as they are immediates anyway
+         * and take over the size of their parent */
+        return VALUE_NONE;
+    }
+}
+
+static MVMint32 is_conditional(MVMint32 op) {
+    return op == MVM_JIT_IF || op == MVM_JIT_IFV || op == MVM_JIT_WHEN ||
+        op == MVM_JIT_ALL || op == MVM_JIT_ANY;
+}
+
+/* The register allocator unifies the value of IF with its branches, and of
+ * DO and COPY with their last child, so these must keep their own nodes */
+static MVMint32 link_is_replaceable(MVMJitExprTree *tree, MVMint32 node, MVMint32 i) {
+    switch (tree->nodes[node]) {
+    case MVM_JIT_IF:
+        return i == 0;
+    case MVM_JIT_DO:
+        return i < MVM_JIT_EXPR_NCHILD(tree, node) - 1;
+    case MVM_JIT_COPY:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+static MVMint32 uses_constant_table(MVMint32 op) {
+    return op == MVM_JIT_CONST_PTR || op == MVM_JIT_CONST_LARGE || op == MVM_JIT_CONST_NUM;
+}
+
+static MVMuint32 hash_node(MVMJitExprTree *tree, MVMint32 node) {
+    MVMJitExprInfo *info = MVM_JIT_EXPR_INFO(tree, node);
+    MVMint32 op = tree->nodes[node];
+    MVMint32 *links = MVM_JIT_EXPR_LINKS(tree, node), *args = MVM_JIT_EXPR_ARGS(tree, node);
+    MVMuint32 hash = 2166136261u, i;
+#define HASH_STEP(x) hash = (hash ^ (MVMuint32)(x)) * 16777619u
+    HASH_STEP(op);
+    HASH_STEP(info->type);
+    HASH_STEP(info->size);
+    for (i = 0; i < info->num_links; i++)
+        HASH_STEP(links[i]);
+    for (i = 0; i < info->num_args; i++) {
+        if (i == 0 && uses_constant_table(op)) {
+            uintptr_t u = tree->constants[args[0]].u;
+            HASH_STEP(u);
+            HASH_STEP((MVMuint64)u >> 32);
+        } else {
+            HASH_STEP(args[i]);
+        }
+    }
+#undef HASH_STEP
+    return hash;
+}
+
+static MVMint32 nodes_are_equal(MVMJitExprTree *tree, MVMint32 a, MVMint32 b) {
+    MVMJitExprInfo *info_a = MVM_JIT_EXPR_INFO(tree, a), *info_b = MVM_JIT_EXPR_INFO(tree, b);
+    MVMint32 op = tree->nodes[a];
+    MVMint32 *args_a = MVM_JIT_EXPR_ARGS(tree, a), *args_b = MVM_JIT_EXPR_ARGS(tree, b);
+    MVMuint32 i;
+    if (op != tree->nodes[b] || info_a->num_links != info_b->num_links ||
+        info_a->num_args != info_b->num_args || info_a->type != info_b->type ||
+        info_a->size != info_b->size)
+        return 0;
+    if (memcmp(MVM_JIT_EXPR_LINKS(tree, a), MVM_JIT_EXPR_LINKS(tree, b),
+               info_a->num_links * sizeof(MVMint32)) != 0)
+        return 0;
+    for (i = 0; i < info_a->num_args; i++) {
+        if (i == 0 && uses_constant_table(op)) {
+            if (tree->constants[args_a[0]].u != tree->constants[args_b[0]].u)
+                return 0;
+        } else if (args_a[i] != args_b[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static MVMint32 is_const(MVMJitExprTree *tree, MVMint32 node, MVMint32 value) {
+    return tree->nodes[node] == MVM_JIT_CONST && MVM_JIT_EXPR_ARGS(tree, node)[0] == value;
+}
+
+static MVMint32 const_fits(MVMint64 value, MVMuint8 size) {
+    switch (size) {
+    case 1: return value >= INT8_MIN && value <= INT8_MAX;
+    case 2: return value >= INT16_MIN && value <= INT16_MAX;
+    default: return value >= INT32_MIN && value <= INT32_MAX;
+    }
+}
+
+/* Try to fold a binary operator over two constants into a CONST node. Both
+ * have two words for links or args, so we can rewrite the node in place */
+static void fold_constants(MVMThreadContext *tc, MVMJitExprTree *tree, MVMint32 node) {
+    MVMint32 *links = MVM_JIT_EXPR_LINKS(tree, node);
+    MVMJitExprInfo *info = MVM_JIT_EXPR_INFO(tree, node);
+    MVMint64 a, b, value;
+    if (tree->nodes[links[0]] != MVM_JIT_CONST || tree->nodes[links[1]] != MVM_JIT_CONST)
+        return;
+    a = MVM_JIT_EXPR_ARGS(tree, links[0])[0];
+    b = MVM_JIT_EXPR_ARGS(tree, links[1])[0];
+    switch (tree->nodes[node]) {
+    case MVM_JIT_ADD: value = a + b; break;
+    case MVM_JIT_SUB: value = a - b; break;
+    case MVM_JIT_MUL: value = a * b; break;
+    case MVM_JIT_AND: value = a & b; break;
+    case MVM_JIT_OR:  value = a | b; break;
+    case MVM_JIT_XOR: value = a ^ b; break;
+    default: return;
+    }
+    if (!const_fits(value, info->size))
+        return;
+    tree->nodes[node] = MVM_JIT_CONST;
+    info->num_links   = 0;
+    info->num_args    = 2;
+    links[0]          = (MVMint32)value;
+    links[1]          = info->size;
+}
+
+/* Returns a node that computes the same value, or the node itself */
+static MVMint32 simplify_node(MVMThreadContext *tc, MVMJitExprTree *tree, MVMint32 node) {
+    MVMint32 *links = MVM_JIT_EXPR_LINKS(tree, node);
+    MVMint32 *args  = MVM_JIT_EXPR_ARGS(tree, node);
+    MVMJitExprInfo *info = MVM_JIT_EXPR_INFO(tree, node);
+    MVMint32 other  = -1;
+    switch (tree->nodes[node]) {
+    case MVM_JIT_ADDR:
+        /* (addr (addr $x a) b) => (addr $x a+b) */
+        if (tree->nodes[links[0]] == MVM_JIT_ADDR) {
+            MVMint64 offset = (MVMint64)args[0] + MVM_JIT_EXPR_ARGS(tree, links[0])[0];
+            if (const_fits(offset, 4)) {
+                args[0]  = (MVMint32)offset;
+                links[0] = MVM_JIT_EXPR_LINKS(tree, links[0])[0];
+            }
+        }
+        return node;
+    case MVM_JIT_ADD:
+    case MVM_JIT_OR:
+    case MVM_JIT_XOR:
+        if (is_const(tree, links[0], 0))
+            other = links[1];
+        /* fallthrough */
+    case MVM_JIT_SUB:
+        if (is_const(tree, links[1], 0))
+            other = links[0];
+        break;
+    case MVM_JIT_MUL:
+        if (is_const(tree, links[0], 1))
+            other = links[1];
+        else if (is_const(tree, links[1], 1))
+            other = links[0];
+        break;
+    default:
+        return node;
+    }
+    if (other < 0) {
+        fold_constants(tc, tree, node);
+        return node;
+    }
+    /* The identity only holds if no (sign) extension was implied */
+    if (MVM_JIT_EXPR_INFO(tree, other)->size == info->size &&
+        (info->type == 0 || (info->type & 0xf) == (MVM_JIT_EXPR_INFO(tree, other)->type & 0xf)))
+        return other;
+    return node;
+}
+
+static void optimize_inorder(MVMThreadContext *tc, MVMJitTreeTraverser *traverser,
+                             MVMJitExprTree *tree, MVMint32 node, MVMint32 child) {
+    struct TreeOptimizer *optimizer = traverser->data;
+    /* everything after the first child of a conditional may not be evaluated */
+    if (child == 0 && is_conditional(tree->nodes[node]))
+        optimizer->cond_depth++;
+}
+
+static void optimize_node(MVMThreadContext *tc, MVMJitTreeTraverser *traverser,
+                          MVMJitExprTree *tree, MVMint32 node) {
+    struct TreeOptimizer *optimizer = traverser->data;
+    MVMint32 op     = tree->nodes[node];
+    MVMint32 nchild = MVM_JIT_EXPR_NCHILD(tree, node);
+    MVMint32 *links = MVM_JIT_EXPR_LINKS(tree, node);
+    MVMint32 i, kind, simplified;
+    MVMuint32 slot;
+
+    for (i = 0; i < nchild; i++) {
+        if (link_is_replaceable(tree, node, i))
+            links[i] = optimizer->replace[links[i]];
+    }
+    if (is_conditional(op) && nchild > 0)
+        optimizer->cond_depth--;
+
+    switch (op) {
+    case MVM_JIT_STORE:
+        optimizer->memory++;
+        break;
+    case MVM_JIT_CALL:
+    case MVM_JIT_CALLN:
+    case MVM_JIT_CALLV:
+    case MVM_JIT_GUARD:
+    case MVM_JIT_MARK:
+        optimizer->barrier++;
+        break;
+    default:
+        break;
+    }
+
+    simplified = simplify_node(tc, tree, node);
+    if (simplified != node) {
+        optimizer->replace[node] = simplified;
+        return;
+    }
+
+    kind = value_kind(tree->nodes[node]);
+    if (kind == VALUE_NONE)
+        return;
+
+    for (slot = hash_node(tree, node) & optimizer->table_mask;
+         optimizer->table[slot] != 0;
+         slot = (slot + 1) & optimizer->table_mask) {
+        MVMint32 other = optimizer->table[slot];
+        if (!nodes_are_equal(tree, other, node))
+            continue;
+        if (optimizer->barrier_at[other] == optimizer->barrier &&
+            (kind != VALUE_LOAD || optimizer->memory_at[other] == optimizer->memory)) {
+            optimizer->replace[node] = other;
+            return;
+        }
+        /* stale; take over the slot */
+        break;
+    }
+    if (optimizer->cond_depth == 0) {
+        optimizer->table[slot]        = node;
+        optimizer->barrier_at[node]   = optimizer->barrier;
+        optimizer->memory_at[node]    = optimizer->memory;
+    }
+}
+
+static void optimize_tree(MVMThreadContext *tc, MVMJitExprTree *tree) {
+    MVMJitTreeTraverser traverser;
+    struct TreeOptimizer optimizer;
+    MVMuint32 i, table_size = 64;
+
+    while (table_size < 2 * tree->nodes_num)
+        table_size *= 2;
+
+    optimizer.replace    = MVM_malloc(tree->nodes_num * sizeof(MVMint32));
+    optimizer.barrier_at = MVM_malloc(tree->nodes_num * sizeof(MVMuint32));
+    optimizer.memory_at  = MVM_malloc(tree->nodes_num * sizeof(MVMuint32));
+    optimizer.table      = MVM_calloc(table_size, sizeof(MVMint32));
+    optimizer.table_mask = table_size - 1;
+    optimizer.barrier    = 0;
+    optimizer.memory     = 0;
+    optimizer.cond_depth = 0;
+    for (i = 0; i < tree->nodes_num; i++)
+        optimizer.replace[i] = i;
+
+    traverser.policy    = MVM_JIT_TRAVERSER_ONCE;
+    traverser.data      = &optimizer;
+    traverser.preorder  = NULL;
+    traverser.inorder   = &optimize_inorder;
+    traverser.postorder = &optimize_node;
+    MVM_jit_expr_tree_traverse(tc, tree, &traverser);
+
+    for (i = 0; i < tree->roots_num; i++)
+        tree->roots[i] = optimizer.replace[tree->roots[i]];
+
+    MVM_free(optimizer.replace);
+    MVM_free(optimizer.barrier_at);
+    MVM_free(optimizer.memory_at);
+    MVM_free(optimizer.table);
+}
+
+
 /* insert stores for all the active unstored values */
 static void active_values_flush(MVMThreadContext *tc, MVMJitExprTree *tree,
                                 struct ValueDefinition *values, MVMint32 num_values) {
@@ -759,6 +1082,14 @@ MVMJitExprTree * MVM_jit_expr_tree_build(MVMThreadContext *tc, MVMJitGraph *jg,
                 after_label = MVM_jit_label_after_ins(tc, jg, iter->bb, ins);
                 jg->inlines[ann->data.inline_idx].end_label = after_label;
                 break;
+            case MVM_SPESH_ANN_LINENO:
+                /* only labeled for the perf jitdump, as the label splits the
+                 * tile list and so blocks the peephole optimizer */
+                if (MVM_jit_perf_dump_enabled(tc)) {
+                    before_label = MVM_jit_label_before_ins(tc, jg, iter->bb, ins);
+                    MVM_jit_graph_add_line_number(tc, jg, before_label, ann);
+                }
+                break;
             case MVM_SPESH_ANN_DEOPT_INLINE:
             case MVM_SPESH_ANN_DEOPT_ONE_INS:
                 /* In so far as we care about these, the relevant deopt index
@@ -891,6 +1222,7 @@ MVMJitExprTree * MVM_jit_expr_tree_build(MVMThreadContext *tc, MVMJitGraph *jg,
     if (tree->roots_num > 0) {
         active_values_flush(tc, tree, values, sg->num_locals);
         MVM_jit_expr_tree_analyze(tc, tree);
+        optimize_tree(tc, tree);
     } else {
         /* Don't return empty trees, nobody wants that */
         MVM_jit_expr_tree_destroy(tc, tree);
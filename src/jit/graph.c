@@ -401,6 +401,7 @@ static void * op_to_func(MVMThreadContext *tc, MVMint16 opcode) {
     case MVM_OP_backtracestrings: return MVM_exception_backtrace_strings;
     case MVM_OP_breakpoint: return MVM_debugserver_breakpoint_check;
     case MVM_OP_sp_getstringfrom: return MVM_cu_string;
+    case MVM_OP_getcode: return MVM_cu_coderef;
     case MVM_OP_encoderepconf: return MVM_string_encode_to_buf_config;
     case MVM_OP_decodeconf: return MVM_string_decode_from_buf_config;
     case MVM_OP_decoderepconf: return MVM_string_decode_from_buf_config;
@@ -463,6 +464,7 @@ static MVMint32 consume_invoke(MVMThreadContext *tc, MVMJitGraph *jg,
     MVMint16      spesh_cand_or_sf_slot;
     MVMint16      is_fast;
     MVMint16      is_resolve = 0;
+    MVMint16      is_tail = 0;
     MVMuint32     resolve_offset = 0;
 
     while ((ins = ins->next)) {
@@ -511,6 +513,14 @@ static MVMint32 consume_invoke(MVMThreadContext *tc, MVMJitGraph *jg,
             spesh_cand_or_sf_slot = -1;
             is_fast               = 0;
             goto checkargs;
+        case MVM_OP_sp_tailinvoke_o:
+            return_type           = MVM_RETURN_OBJ;
+            return_register       = ins->operands[0].reg.orig;
+            code_register_or_name = ins->operands[1].reg.orig;
+            spesh_cand_or_sf_slot = -1;
+            is_fast               = 0;
+            is_tail               = 1;
+            goto checkargs;
         case MVM_OP_nativeinvoke_o: {
             MVMint16 dst     = ins->operands[0].reg.orig;
             MVMint16 restype = ins->operands[2].reg.orig;
@@ -609,6 +619,7 @@ static MVMint32 consume_invoke(MVMThreadContext *tc, MVMJitGraph *jg,
     node->u.invoke.reentry_label         = reentry_label;
     node->u.invoke.is_fast               = is_fast;
     node->u.invoke.is_resolve            = is_resolve;
+    node->u.invoke.is_tail               = is_tail;
     jg_append_node(jg, node);
 
     /* append reentry label */
@@ -743,6 +754,14 @@ static void before_ins(MVMThreadContext *tc, MVMJitGraph *jg,
             has_label = 1;
             break;
         }
+        case MVM_SPESH_ANN_LINENO: {
+            if (!MVM_jit_perf_dump_enabled(tc))
+                break;
+            label = MVM_jit_label_before_ins(tc, jg, bb, ins);
+            MVM_jit_graph_add_line_number(tc, jg, label, ann);
+            has_label = 1;
+            break;
+        }
         } /* switch */
         ann = ann->next;
     }
@@ -1865,7 +1884,6 @@ start:
     case MVM_OP_ctxlexpad:
     case MVM_OP_ctxcallerskipthunks:
     case MVM_OP_curcode:
-    case MVM_OP_getcode:
     case MVM_OP_sp_fastcreate:
     case MVM_OP_iscont:
     case MVM_OP_decont:
@@ -2113,6 +2131,15 @@ start:
         jg_append_call_c(tc, jg, op_to_func(tc, op), 4, args, MVM_JIT_RV_PTR, dst);
         break;
     }
+    case MVM_OP_getcode: {
+        MVMint16  dst = ins->operands[0].reg.orig;
+        MVMuint16 idx = ins->operands[1].coderef_idx;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, { MVM_JIT_INTERP_TC } },
+                                 { MVM_JIT_INTERP_VAR, { MVM_JIT_INTERP_CU } },
+                                 { MVM_JIT_LITERAL, { idx } } };
+        jg_append_call_c(tc, jg, op_to_func(tc, op), 3, args, MVM_JIT_RV_PTR, dst);
+        break;
+    }
     case MVM_OP_scgetobjidx: {
         MVMint16 dst = ins->operands[0].reg.orig;
         MVMint16 sc  = ins->operands[1].reg.orig;
@@ -3769,6 +3796,13 @@ start:
     case MVM_OP_sp_guardsf:
         jg_append_guard(tc, jg, ins, 2);
         break;
+    case MVM_OP_sp_deopt: {
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, { MVM_JIT_INTERP_TC } },
+                                 { MVM_JIT_LITERAL, { ins->operands[0].lit_ui32 } } };
+        jg_append_call_c(tc, jg, &MVM_spesh_deopt_one, 2, args, MVM_JIT_RV_VOID, -1);
+        jg_append_deopt_check(tc, jg);
+        break;
+    }
     case MVM_OP_sp_resolvecode: {
         MVMint16 dst     = ins->operands[0].reg.orig;
         MVMint16 obj     = ins->operands[1].reg.orig;
@@ -4019,6 +4053,9 @@ MVMJitGraph * MVM_jit_try_make_graph(MVMThreadContext *tc, MVMSpeshGraph *sg) {
 
     graph->expr_seq_nr = 0;
 
+    /* Line numbers are only interesting to external profilers */
+    MVM_VECTOR_INIT(graph->lines, 0);
+
     /* JIT handlers are indexed by spesh graph handler index */
     if (sg->num_handlers > 0) {
         MVM_VECTOR_INIT(graph->handlers, sg->num_handlers);
@@ -4062,6 +4099,20 @@ MVMJitGraph * MVM_jit_try_make_graph(MVMThreadContext *tc, MVMSpeshGraph *sg) {
     return NULL;
 }
 
+/* Records a line number annotation at a label. The expression builder may
+ * bail on an instruction that is then compiled by the graph builder, which
+ * would record the same label twice in a row. */
+void MVM_jit_graph_add_line_number(MVMThreadContext *tc, MVMJitGraph *jg, MVMint32 label, MVMSpeshAnn *ann) {
+    MVMJitLineNumber line;
+    line.label        = label;
+    line.filename_idx = ann->data.lineno.filename_string_index;
+    line.line_number  = ann->data.lineno.line_number;
+    if (jg->lines_num > 0 && jg->lines[jg->lines_num - 1].label == label)
+        jg->lines[jg->lines_num - 1] = line;
+    else
+        MVM_VECTOR_PUSH(jg->lines, line);
+}
+
 void MVM_jit_graph_destroy(MVMThreadContext *tc, MVMJitGraph *graph) {
     MVMJitNode *node;
     /* destroy all trees */
@@ -4075,4 +4126,5 @@ void MVM_jit_graph_destroy(MVMThreadContext *tc, MVMJitGraph *graph) {
     MVM_free(graph->deopts);
     MVM_free(graph->handlers);
     MVM_free(graph->inlines);
+    MVM_free(graph->lines);
 }
@@ -22,6 +22,8 @@ struct MVMJitGraph {
     MVM_VECTOR_DECL(MVMJitHandler, handlers);
     MVM_VECTOR_DECL(MVMJitInline, inlines);
     MVM_VECTOR_DECL(MVMJitNode*, label_nodes);
+    /* Line number labels, only collected for the perf jitdump */
+    MVM_VECTOR_DECL(MVMJitLineNumber, lines);
 };
 
 struct MVMJitDeopt {
@@ -40,6 +42,14 @@ struct MVMJitInline {
     MVMint32 end_label;
 };
 
+/* Filename index is relative to the compunit of the (inlined) frame that
+ * covers the label, which is resolved when the code is dumped */
+struct MVMJitLineNumber {
+    MVMint32  label;
+    MVMuint32 filename_idx;
+    MVMuint32 line_number;
+};
+
 /* A label (no more than a number) */
 struct MVMJitLabel {
     MVMint32    name;
@@ -186,6 +196,7 @@ struct MVMJitInvoke {
     MVMint16      spesh_cand_or_sf_slot;
     MVMint8       is_fast;
     MVMint8       is_resolve;
+    MVMint8       is_tail;
     MVMuint32     resolve_offset;           /* Only for spesh resolve */
     MVMint32      reentry_label;
 };
@@ -243,4 +254,5 @@ struct MVMJitNode {
 };
 
 MVMJitGraph* MVM_jit_try_make_graph(MVMThreadContext *tc, MVMSpeshGraph *sg);
+void MVM_jit_graph_add_line_number(MVMThreadContext *tc, MVMJitGraph *jg, MVMint32 label, MVMSpeshAnn *ann);
 void MVM_jit_graph_destroy(MVMThreadContext *tc, MVMJitGraph *graph);
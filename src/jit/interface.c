@@ -62,6 +62,48 @@ void MVM_jit_code_trampoline(MVMThreadContext *tc) {
     }
 }
 
+/* Invokes a callee whose specialization was resolved by spesh, on behalf of
+ * JIT-compiled code. Usually the caller then leaves to the interpreter, which
+ * enters the callee's machine code, and once that returns, enters the caller's
+ * machine code again. If the callee was JIT-compiled too, we instead run it
+ * directly from here. If it then returns normally, we undo the trampoline, and
+ * the caller carries on in place. If anything else happened - an exception was
+ * handled elsewhere, the caller was deoptimized, a continuation was taken -
+ * the caller leaves to the interpreter just as it would have. */
+void MVM_jit_invoke_direct(MVMThreadContext *tc, MVMCode *code, MVMCallsite *callsite,
+                           MVMint32 spesh_cand) {
+    void **caller_return_address = tc->jit_return_address;
+    void *resume_label = caller_return_address ? *caller_return_address : NULL;
+    MVMFrame *caller = tc->cur_frame;
+    MVMint32 caller_nr = caller->sequence_nr;
+    MVMRegister *caller_work = caller->work;
+    MVMSpeshCandidate *caller_cand = caller->spesh_cand;
+    MVMFrame *callee;
+    MVMJitCode *callee_code;
+
+    MVM_frame_invoke_code(tc, code, callsite, spesh_cand);
+
+    /* Only go direct if the interpreter would enter machine code next. */
+    callee = tc->cur_frame;
+    callee_code = callee->spesh_cand ? callee->spesh_cand->jitcode : NULL;
+    if (!resume_label || !callee_code || *(tc->interp_cur_op) != callee_code->bytecode
+            || tc->jit_direct_call_depth >= MVM_JIT_MAX_DIRECT_CALL_DEPTH)
+        return;
+
+    tc->jit_direct_call_depth++;
+    MVM_jit_code_enter(tc, callee_code, callee->static_info->body.cu);
+    tc->jit_direct_call_depth--;
+
+    /* The caller may have moved to the heap, so identify it by sequence
+     * number. */
+    if (tc->cur_frame && tc->cur_frame->sequence_nr == caller_nr
+            && tc->cur_frame->work == caller_work
+            && tc->cur_frame->spesh_cand == caller_cand
+            && tc->cur_frame->jit_entry_label == resume_label) {
+        *caller_return_address = resume_label;
+        tc->jit_return_address = caller_return_address;
+    }
+}
 
 MVMuint32 MVM_jit_code_get_active_deopt_idx(MVMThreadContext *tc, MVMJitCode *code, MVMFrame *frame) {
     MVMuint32 i;
@@ -16,3 +16,10 @@ MVMint32 MVM_jit_code_get_active_inlines(MVMThreadContext *tc, MVMJitCode *code,
 
 /* hackish interface */
 void MVM_jit_code_trampoline(MVMThreadContext *tc);
+
+/* How deep JIT-compiled code may nest direct calls to other JIT-compiled
+ * code on the C stack before falling back to going via the interpreter. */
+#define MVM_JIT_MAX_DIRECT_CALL_DEPTH 128
+
+void MVM_jit_invoke_direct(MVMThreadContext *tc, MVMCode *code, MVMCallsite *callsite,
+                           MVMint32 spesh_cand);
@@ -58,6 +58,8 @@ void MVM_jit_emit_copy(MVMThreadContext *tc, MVMJitCompiler *compiler,
                        MVMint8 dst_reg, MVMint8 src_num);
 void MVM_jit_emit_marker(MVMThreadContext *tc, MVMJitCompiler *compiler, MVMint32 num);
 void MVM_jit_emit_deopt_check(MVMThreadContext *tc, MVMJitCompiler *compiler);
+void MVM_jit_emit_arg_guard(MVMThreadContext *tc, MVMJitCompiler *compiler,
+                            MVMSpeshArgGuard *ag);
 
 MVMuint32 MVM_jit_spill_memory_select(MVMThreadContext *tc, MVMJitCompiler *compiler, MVMint8 reg_type);
 void MVM_jit_spill_memory_release(MVMThreadContext *tc, MVMJitCompiler *compiler, MVMuint32 pos, MVMint8 reg_type);
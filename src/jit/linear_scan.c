@@ -336,7 +336,7 @@ MVMint8 try_preferred_register(MVMThreadContext *tc, RegisterAllocator *alc, MVM
     /* Tile has at least one operand.
      * That operand is free.
      * It is also of the desired register class */
-    if (tile->num_refs >= 1 && MVM_JIT_REGISTER_IS_USED(tile->refs[1]) &&
+    if (tile->num_refs >= 1 && MVM_JIT_REGISTER_IS_USED(tile->register_spec[1]) &&
         MVM_bitmap_get_low(alc->reg_free, tile->values[1]) & reg_perm)
         return tile->values[1];
     return -1;
@@ -724,21 +724,88 @@ static MVMint32 insert_store_after_definition(MVMThreadContext *tc, RegisterAllo
     return n;
 }
 
+/* A live range that reloads a spilled value (rather than defining one) keeps
+ * using the spill slot of the value it was split from */
+MVM_STATIC_INLINE MVMint32 live_range_is_reload(LiveRange *range) {
+    return range->synthetic[0] != NULL;
+}
+
+static MVMuint32 live_range_spill_position(MVMThreadContext *tc, RegisterAllocator *alc, MVMuint32 v) {
+    LiveRange *range = alc->values + v;
+    if (live_range_is_reload(range))
+        return range->synthetic[0]->args[1];
+    return MVM_jit_spill_memory_select(tc, alc->compiler, range->reg_type);
+}
+
+/* Order number of the first reference at or after code_pos */
+static MVMuint32 live_range_next_use(LiveRange *range, MVMuint32 code_pos) {
+    ValueRef *ref;
+    for (ref = range->first; ref != NULL; ref = ref->next) {
+        if (order_nr(ref->tile_idx) >= code_pos)
+            return order_nr(ref->tile_idx);
+    }
+    return range->end;
+}
+
+/* Spill the value whose next use is furthest away (Belady), rather than the
+ * one which is last to expire; a long-lived value that is only used at the
+ * start and end of a tree does not need to hold a register in between. Ties
+ * are broken in favor of the value with the longest remaining extent. */
 static MVMuint32 select_live_range_for_spill(MVMThreadContext *tc, RegisterAllocator *alc, MVMJitTileList *list, MVMint32 code_pos, MVMBitmap reg_perm) {
-    int i;
+    MVMint32 i, best = -1;
+    MVMuint32 best_use = 0;
     for (i = alc->active_top - 1; i >= 0; i--) {
         LiveRange *r = alc->values + alc->active[i];
-        if (MVM_bitmap_get_low(reg_perm, r->reg_num))
-            return alc->active[i];
+        MVMuint32 next_use;
+        if (!MVM_bitmap_get_low(reg_perm, r->reg_num))
+            continue;
+        next_use = live_range_next_use(r, code_pos);
+        if (best < 0 || next_use > best_use ||
+                (next_use == best_use && r->end > alc->values[best].end)) {
+            best     = alc->active[i];
+            best_use = next_use;
+        }
     }
+    if (best >= 0)
+        return best;
     MVM_panic(1, "JIT compiler did not find a live range for spill");
 }
 
+/* Index of the tile list block containing tile_idx */
+static MVMuint32 tile_block(MVMJitTileList *list, MVMuint32 tile_idx) {
+    MVMuint32 lo = 0, hi = list->blocks_num;
+    while (hi - lo > 1) {
+        MVMuint32 mid = (lo + hi) / 2;
+        if (list->blocks[mid].start <= tile_idx)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* A single reload can serve several uses of a spilled value, provided they are
+ * in the same block (so the load is executed on every path reaching them) and
+ * no CALL intervenes (which would clobber the register again) */
+static MVMint32 can_share_reload(MVMJitTileList *list, MVMuint32 from_idx, MVMuint32 to_idx) {
+    MVMuint32 i;
+    if (tile_block(list, from_idx) != tile_block(list, to_idx))
+        return 0;
+    for (i = from_idx + 1; i <= to_idx; i++) {
+        if (MVM_jit_expr_op_is_call(list->items[i]->op))
+            return 0;
+    }
+    return 1;
+}
+
 
 static void live_range_spill(MVMThreadContext *tc, RegisterAllocator *alc, MVMJitTileList *list,
                              MVMuint32 to_spill, MVMuint32 spill_pos, MVMuint32 code_pos) {
 
     MVMint8 reg_spilled = alc->values[to_spill].reg_num;
+    MVMint32 is_reload  = live_range_is_reload(alc->values + to_spill);
+    /* live range for the current run of future uses sharing a reload */
+    MVMint32 reload     = -1;
     /* loop over all value refs */
     _DEBUG("Spilling live range value %d to memory position %d at %d", to_spill, spill_pos, code_pos);
 
@@ -756,9 +823,19 @@ static void live_range_spill(MVMThreadContext *tc, RegisterAllocator *alc, MVMJi
              * consume more registers than we have available. Past ARGLISTs have
              * already been handled, so we do need to insert a load a before
              * them (or modify in place, but, complex!). */
+            reload = -1;
             continue;
         } else if (is_definition(ref)) {
+            reload = -1;
             n = insert_store_after_definition(tc, alc, list, ref, spill_pos);
+        } else if (reload >= 0 && can_share_reload(list, alc->values[reload].last->tile_idx, ref->tile_idx)) {
+            /* split rather than spill: extend the live range of the previous
+             * reload to cover this use as well */
+            LiveRange *range = alc->values + reload;
+            range->last->next = ref;
+            range->last       = ref;
+            range->end        = order_nr(ref->tile_idx);
+            continue;
         } else {
             n = insert_load_before_use(tc, alc, list, ref, spill_pos);
         }
@@ -771,6 +848,8 @@ static void live_range_spill(MVMThreadContext *tc, RegisterAllocator *alc, MVMJi
             MVM_VECTOR_PUSH(alc->retired, n);
         } else {
             /* in the future, which means we need to add it to the worklist */
+            if (!is_definition(ref))
+                reload = n;
             MVM_VECTOR_ENSURE_SPACE(alc->worklist, 1);
             live_range_heap_push(alc->values, alc->worklist, &alc->worklist_num, n,
                                  values_cmp_first_ref);
@@ -784,6 +863,10 @@ static void live_range_spill(MVMThreadContext *tc, RegisterAllocator *alc, MVMJi
     alc->values[to_spill].spill_pos = spill_pos;
     alc->values[to_spill].spill_idx = code_pos;
     free_register(tc, alc, reg_spilled);
+    if (is_reload) {
+        /* the spill slot is owned (and released) by the original value */
+        return;
+    }
     MVM_VECTOR_ENSURE_SPACE(alc->spilled, 1);
     live_range_heap_push(alc->values, alc->spilled, &alc->spilled_num,
                          to_spill, values_cmp_last_ref);
@@ -845,7 +928,7 @@ static void prepare_arglist_and_call(MVMThreadContext *tc, RegisterAllocator *al
         MVMuint32 code_pos = order_nr(call_idx);
         if (v->end > code_pos && live_range_has_hole(v, code_pos) == NULL) {
             /* surviving values need to be spilled */
-            MVMint32 spill_pos = MVM_jit_spill_memory_select(tc, alc->compiler, v->reg_type);
+            MVMint32 spill_pos = live_range_spill_position(tc, alc, alc->active[i]);
             /* spilling at the CALL idx will mean that the spiller inserts a
              * LOAD at the current register before the ARGLIST, meaning it
              * remains 'live' for this ARGLIST */
@@ -1077,7 +1160,7 @@ static void process_live_range(MVMThreadContext *tc, RegisterAllocator *alc, MVM
             /* choose a live range, a register to spill, and a spill location */
             /* also one that is valid for this register type */
             MVMuint32 to_spill   = select_live_range_for_spill(tc, alc, list, tile_order_nr, reg_perm);
-            MVMuint32 spill_pos  = MVM_jit_spill_memory_select(tc, alc->compiler, alc->values[to_spill].reg_type);
+            MVMuint32 spill_pos  = live_range_spill_position(tc, alc, to_spill);
             active_set_splice(tc, alc, to_spill);
             _DEBUG("Spilling live range %d at %d to %d to free up a register",
 `                   to_spill, tile_order_nr, spill_pos);
@@ -25,6 +25,19 @@ void MVM_jit_code_destroy(MVMThreadContext *tc, MVMJitCode *code) {
     return;
 }
 
+MVMSpeshArgGuardJitFunc MVM_jit_compile_arg_guard(MVMThreadContext *tc, MVMSpeshArgGuard *ag,
+                                                  size_t *size) {
+    return NULL;
+}
+
+void MVM_jit_free_code(MVMThreadContext *tc, void *memory, size_t size, MVMuint32 safe) {
+    return;
+}
+
+void MVM_jit_code_safepoint(MVMThreadContext *tc) {
+    return;
+}
+
 void MVM_jit_code_enter(MVMThreadContext *tc, MVMJitCode *code, MVMCompUnit *cu) {
     return;
 }
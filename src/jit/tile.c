@@ -902,3 +902,97 @@ void MVM_jit_tile_list_destroy(MVMThreadContext *tc, MVMJitTileList *list) {
     MVM_free(list->inserts);
     MVM_free(list->blocks);
 }
+
+
+/* Peephole optimization of the tile list, after register allocation. Each rule
+ * is applied to a pair of consecutive tiles that emit code (tiles without an
+ * emit rule produce no code, so they are skipped), and may edit the tiles in
+ * place or remove them by clearing their emit rule. A label or branch tile is
+ * never matched, so no rule looks across a basic block boundary. */
+
+MVM_STATIC_INLINE MVMint32 is_local_storage(MVMJitTile *tile) {
+    return tile->args[0] == MVM_JIT_STORAGE_LOCAL;
+}
+
+/* mov r, r */
+static MVMint32 peephole_redundant_move(MVMThreadContext *tc, MVMJitTile *a, MVMJitTile *b) {
+    if (a->emit == MVM_jit_compile_move && a->values[0] == a->values[1]) {
+        a->emit = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/* mov [local+x], r1; mov r2, [local+x] => mov [local+x], r1; mov r2, r1 */
+static MVMint32 peephole_store_load(MVMThreadContext *tc, MVMJitTile *a, MVMJitTile *b) {
+    if (a->emit == MVM_jit_compile_store && b->emit == MVM_jit_compile_load &&
+        is_local_storage(a) && is_local_storage(b) && a->args[1] == b->args[1]) {
+        b->emit       = MVM_jit_compile_move;
+        b->values[1]  = a->values[1];
+        b->debug_name = "#move (forwarded store)";
+        return 1;
+    }
+    return 0;
+}
+
+/* mov r1, [local+x]; mov r2, [local+x] => mov r1, [local+x]; mov r2, r1 */
+static MVMint32 peephole_load_load(MVMThreadContext *tc, MVMJitTile *a, MVMJitTile *b) {
+    if (a->emit == MVM_jit_compile_load && b->emit == MVM_jit_compile_load &&
+        is_local_storage(a) && is_local_storage(b) && a->args[1] == b->args[1]) {
+        b->emit       = MVM_jit_compile_move;
+        b->values[1]  = a->values[0];
+        b->debug_name = "#move (forwarded load)";
+        return 1;
+    }
+    return 0;
+}
+
+/* and r, x; test r, r => and r, x
+ * The 64 bit ALU operations set ZF just like the test would, and a test for
+ * (non)zero-ness reads nothing else */
+static MVMint32 peephole_alu_test(MVMThreadContext *tc, MVMJitTile *a, MVMJitTile *b) {
+    if (b->emit != MVM_JIT_TILE_NAME(test) ||
+        (b->op != MVM_JIT_NZ && b->op != MVM_JIT_ZR) ||
+        b->size == 1 || b->size == 2 || b->size == 4 ||
+        b->values[1] != a->values[0])
+        return 0;
+    if (a->emit == MVM_JIT_TILE_NAME(add_reg) || a->emit == MVM_JIT_TILE_NAME(add_const) ||
+        a->emit == MVM_JIT_TILE_NAME(sub_reg) || a->emit == MVM_JIT_TILE_NAME(sub_const) ||
+        a->emit == MVM_JIT_TILE_NAME(and_reg) || a->emit == MVM_JIT_TILE_NAME(and_const) ||
+        a->emit == MVM_JIT_TILE_NAME(or_reg)  || a->emit == MVM_JIT_TILE_NAME(xor_reg)) {
+        b->emit = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+static const struct {
+    const char *name;
+    MVMint32 (*apply)(MVMThreadContext *tc, MVMJitTile *a, MVMJitTile *b);
+} peephole_rules[] = {
+    { "store-load",     peephole_store_load },
+    { "load-load",      peephole_load_load },
+    { "redundant-move", peephole_redundant_move },
+    { "alu-test",       peephole_alu_test },
+};
+
+void MVM_jit_tile_list_peephole(MVMThreadContext *tc, MVMJitTileList *list) {
+    MVMuint32 i, j, r;
+    if (!tc->instance->jit_peephole_enabled)
+        return;
+    for (i = 0; i < list->items_num; i = j) {
+        MVMJitTile *a = list->items[i], *b;
+        /* find the next tile that emits code */
+        for (j = i + 1; j < list->items_num && list->items[j]->emit == NULL; j++);
+        if (a->emit == NULL)
+            continue;
+        b = j < list->items_num ? list->items[j] : NULL;
+        for (r = 0; r < MVM_ARRAY_SIZE(peephole_rules) && a->emit != NULL; r++) {
+            if (b == NULL && peephole_rules[r].apply != peephole_redundant_move)
+                continue;
+            if (peephole_rules[r].apply(tc, a, b) && MVM_jit_debug_enabled(tc))
+                MVM_spesh_debug_printf(tc, "Peephole rule %s applied at tile %u\n",
+                                       peephole_rules[r].name, i);
+        }
+    }
+}
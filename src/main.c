@@ -87,14 +87,20 @@ The following environment variables are respected:\n\
     MVM_SPESH_INLINE_DISABLE    Disables inlining\n\
     MVM_SPESH_OSR_DISABLE       Disables on-stack replacement\n\
     MVM_SPESH_PEA_DISABLE       Disables partial escape analysis and related optimizations\n\
+    MVM_SPESH_TAILCALL_DISABLE  Disables tail calls, keeping all frames in backtraces\n\
     MVM_SPESH_BLOCKING          Blocks log-sending thread while specializer runs\n\
     MVM_SPESH_LOG               Specifies a dynamic optimizer log file\n\
     MVM_SPESH_NODELAY           Run dynamic optimization even for cold frames\n\
     MVM_SPESH_LIMIT             Limit the maximum number of specializations\n\
+    MVM_SPESH_MEMORY_LIMIT      Megabytes specializations may use before cold ones are evicted\n\
+    MVM_DESERIALIZE_THREADS     Number of threads that eagerly deserialize loaded modules\n\
+    MVM_VALIDATION_CACHE        Directory to cache bytecode validation results in\n\
     MVM_JIT_DISABLE             Disables JITting to machine code\n\
     MVM_JIT_EXPR_DISABLE        Disable advanced 'expression' JIT\n\
+    MVM_JIT_PEEPHOLE_DISABLE    Disable peephole optimization of expression JIT output\n\
     MVM_JIT_DEBUG               Add JIT debugging information to spesh log\n\
     MVM_JIT_PERF_MAP            Create a map file for the 'perf' profiler (linux only)\n\
+    MVM_JIT_PERF_DUMP           Create a jitdump file for 'perf inject --jit' (linux only)\n\
     MVM_JIT_DUMP_BYTECODE       Dump bytecode in temporary directory\n\
     MVM_SPESH_INLINE_LOG        Dump details of inlining attempts to stderr\n\
     MVM_CROSS_THREAD_WRITE_LOG  Log unprotected cross-thread object writes to stderr\n\
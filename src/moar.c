@@ -105,9 +105,10 @@ MVMInstance * MVM_vm_create_instance(void) {
 
     char *spesh_log, *spesh_nodelay, *spesh_disable, *spesh_inline_disable,
          *spesh_osr_disable, *spesh_limit, *spesh_blocking, *spesh_inline_log,
-         *spesh_pea_disable;
+         *spesh_pea_disable, *spesh_tailcall_disable, *spesh_memory_limit,
+         *predecode_disable;
     char *jit_expr_disable, *jit_disable, *jit_last_frame, *jit_last_bb;
-    char *dynvar_log;
+    char *dynvar_log, *deserialize_threads, *validation_cache;
     int init_stat;
 
 #ifndef MVM_THREAD_LOCAL
@@ -261,6 +262,7 @@ MVMInstance * MVM_vm_create_instance(void) {
     /* Mutex for spesh installations, and check if we've a file we
      * should log specializations to. */
     init_mutex(instance->mutex_spesh_install, "spesh installations");
+    init_mutex(instance->mutex_spesh_candidates, "spesh candidates");
     spesh_log = getenv("MVM_SPESH_LOG");
     if (spesh_log && spesh_log[0])
         instance->spesh_log_fh
@@ -277,8 +279,16 @@ MVMInstance * MVM_vm_create_instance(void) {
         spesh_pea_disable = getenv("MVM_SPESH_PEA_DISABLE");
         if (!spesh_pea_disable || !spesh_pea_disable[0])
             instance->spesh_pea_enabled = 1;
+        spesh_tailcall_disable = getenv("MVM_SPESH_TAILCALL_DISABLE");
+        if (!spesh_tailcall_disable || !spesh_tailcall_disable[0])
+            instance->spesh_tailcall_enabled = 1;
     }
 
+    /* Should we pre-decode hot runs of simple ops in unspecialized code? */
+    predecode_disable = getenv("MVM_PREDECODE_DISABLE");
+    if (!predecode_disable || !predecode_disable[0])
+        instance->predecode_enabled = 1;
+
     init_mutex(instance->mutex_parameterization_add, "parameterization");
 
     /* Should we specialize without warm up delays? Used to find bugs in the
@@ -294,6 +304,25 @@ MVMInstance * MVM_vm_create_instance(void) {
     if (spesh_limit && spesh_limit[0])
         instance->spesh_limit = atoi(spesh_limit);
 
+    /* How much memory, in megabytes, may specializations hold on to before
+     * we start evicting the least recently used ones? Zero means no limit. */
+    spesh_memory_limit = getenv("MVM_SPESH_MEMORY_LIMIT");
+    instance->spesh_memory_limit = (size_t)(spesh_memory_limit && spesh_memory_limit[0]
+        ? atoi(spesh_memory_limit)
+        : MVM_SPESH_DEFAULT_MEMORY_LIMIT) * 1024 * 1024;
+
+    /* How many helper threads should eagerly deserialize SCs as they are
+     * loaded? None means deserialization is done lazily, on demand. */
+    deserialize_threads = getenv("MVM_DESERIALIZE_THREADS");
+    if (deserialize_threads && deserialize_threads[0] && atoi(deserialize_threads) > 0)
+        instance->num_deserialize_threads = atoi(deserialize_threads);
+
+    /* Should validation results be cached on disk, and where? */
+    validation_cache = getenv("MVM_VALIDATION_CACHE");
+    if (validation_cache && validation_cache[0])
+        instance->validation_cache_dir = strdup(validation_cache);
+    init_mutex(instance->mutex_validation_caches, "validation caches");
+
     /* Should we enforce that a thread, when sending work to the specialzation
      * worker, block until the specialization worker is done? This is useful
      * for getting more predictable behavior when debugging. */
@@ -315,6 +344,12 @@ MVMInstance * MVM_vm_create_instance(void) {
     if (!jit_expr_disable || strlen(jit_expr_disable) == 0)
         instance->jit_expr_enabled = 1;
 
+    {
+        char *jit_peephole_disable = getenv("MVM_JIT_PEEPHOLE_DISABLE");
+        if (!jit_peephole_disable || !jit_peephole_disable[0])
+            instance->jit_peephole_enabled = 1;
+    }
+
 
     {
         char *jit_debug = getenv("MVM_JIT_DEBUG");
@@ -332,6 +367,11 @@ MVMInstance * MVM_vm_create_instance(void) {
             instance->jit_perf_map = MVM_platform_fopen(perf_map_filename, "w");
         }
     }
+    {
+        char *jit_perf_dump = getenv("MVM_JIT_PERF_DUMP");
+        if (jit_perf_dump && *jit_perf_dump)
+            MVM_jit_perf_dump_open(instance);
+    }
 #endif
 
     {
@@ -443,6 +483,9 @@ MVMInstance * MVM_vm_create_instance(void) {
     MVM_spesh_worker_start(instance->main_thread);
     MVM_spesh_log_initialize_thread(instance->main_thread, 1);
 
+    /* Set up any deserialization helper threads. */
+    MVM_deserialize_worker_start(instance->main_thread);
+
     /* Back to nursery allocation, now we're set up. */
     MVM_gc_allocate_gen2_default_clear(instance->main_thread);
 
@@ -589,6 +632,9 @@ void MVM_vm_exit(MVMInstance *instance) {
     MVM_thread_join_foreground(instance->main_thread);
     MVM_io_flush_standard_handles(instance->main_thread);
 
+    /* Write any new validation results. */
+    MVM_validation_cache_flush(instance);
+
     /* Close any spesh or jit log. */
     if (instance->spesh_log_fh)
         fclose(instance->spesh_log_fh);
@@ -638,7 +684,9 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
 
     /* Stop system threads */
     MVM_spesh_worker_stop(instance->main_thread);
+    MVM_deserialize_worker_stop(instance->main_thread);
     MVM_spesh_worker_join(instance->main_thread);
+    MVM_deserialize_worker_join(instance->main_thread);
     MVM_io_eventloop_destroy(instance->main_thread);
 
     /* Run the normal GC one more time to actually collect the spesh thread */
@@ -666,6 +714,8 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
 
     /* Clean up safepoint free vector. */
     MVM_VECTOR_DESTROY(instance->free_at_safepoint);
+    MVM_jit_code_safepoint(instance->main_thread);
+    MVM_VECTOR_DESTROY(instance->jit_free_at_safepoint);
     uv_mutex_destroy(&instance->mutex_free_at_safepoint);
 
     /* Clean up Hash of HLLConfig. */
@@ -718,12 +768,15 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
 
     /* Clean up spesh mutexes and close any log. */
     uv_mutex_destroy(&instance->mutex_spesh_install);
+    uv_mutex_destroy(&instance->mutex_spesh_candidates);
     uv_cond_destroy(&instance->cond_spesh_sync);
     uv_mutex_destroy(&instance->mutex_spesh_sync);
     if (instance->spesh_log_fh)
         fclose(instance->spesh_log_fh);
     if (instance->jit_perf_map)
         fclose(instance->jit_perf_map);
+    if (instance->jit_perf_dump)
+        MVM_jit_perf_dump_close(instance);
     if (instance->dynvar_log_fh)
         fclose(instance->dynvar_log_fh);
     if (instance->jit_bytecode_dir)
@@ -732,6 +785,11 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
         MVM_VECTOR_DESTROY(instance->jit_breakpoints);
     }
 
+    /* Write out any new validation results. */
+    MVM_validation_cache_teardown(instance);
+    uv_mutex_destroy(&instance->mutex_validation_caches);
+    MVM_free(instance->validation_cache_dir);
+
 
     /* Clean up cross-thread-write-logging mutex */
     uv_mutex_destroy(&instance->mutex_cross_thread_write_logging);
@@ -127,6 +127,8 @@ MVM_PUBLIC MVMint32 MVM_jit_support(void);
 #include "core/frame.h"
 #include "core/callstack.h"
 #include "core/validation.h"
+#include "core/predecode.h"
+#include "core/validation_cache.h"
 #include "core/bytecode.h"
 #include "core/bytecodedump.h"
 #include "core/ops.h"
@@ -146,11 +148,13 @@ MVM_PUBLIC MVMint32 MVM_jit_support(void);
 #include "core/dll.h"
 #include "core/continuation.h"
 #include "debug/debugserver.h"
+#include "core/inline_cache.h"
 #include "6model/reprs.h"
 #include "6model/reprconv.h"
 #include "6model/bootstrap.h"
 #include "6model/sc.h"
 #include "6model/serialization.h"
+#include "6model/deserialize_worker.h"
 #include "6model/parametric.h"
 #include "core/compunit.h"
 #include "gc/gen2.h"
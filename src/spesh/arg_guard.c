@@ -54,6 +54,8 @@ static MVMSpeshArgGuard * allocate_tree(MVMThreadContext *tc, MVMuint32 total_no
     tree->nodes = (MVMSpeshArgGuardNode *)((char *)tree + sizeof(MVMSpeshArgGuard));
     tree->used_nodes = 0;
     tree->num_nodes = total_nodes;
+    tree->jitcode = NULL;
+    tree->jitcode_size = 0;
     return tree;
 }
 
@@ -368,6 +370,17 @@ void MVM_spesh_arg_guard_regenerate(MVMThreadContext *tc, MVMSpeshArgGuard **gua
         tree_size++; 
     }
 
+    /* If all candidates were discarded, there is no guard tree to build. */
+    if (MVM_VECTOR_ELEMS(by_callsite) == 0) {
+        MVM_VECTOR_DESTROY(by_callsite);
+        if (*guard_ptr) {
+            MVMSpeshArgGuard *prev = *guard_ptr;
+            *guard_ptr = NULL;
+            MVM_spesh_arg_guard_destroy(tc, prev, 1);
+        }
+        return;
+    }
+
     /* Allocate the guards tree, and add a node for each callsite (we do it
      * this way so the callsite selection ones are bunched at the start); we
      * then make a second pass to attach per-callsite nodes. */
@@ -388,6 +401,13 @@ void MVM_spesh_arg_guard_regenerate(MVMThreadContext *tc, MVMSpeshArgGuard **gua
         add_nodes_for_callsite(tc, tree, i, candidates, by_callsite[i]);
     assert(tree->used_nodes <= tree->num_nodes);
 
+    /* Compile the tree to machine code if we can; selection happens on every
+     * invocation of the frame, so it is worth not interpreting it. As in the
+     * interpreter, container fetch and can_store are called directly; decont
+     * types are only logged for containers whose fetch never invokes. */
+    if (tc->instance->jit_enabled)
+        tree->jitcode = MVM_jit_compile_arg_guard(tc, tree, &(tree->jitcode_size));
+
     /* Install the produced argument guard. */
     if (*guard_ptr) {
         MVMSpeshArgGuard *prev = *guard_ptr;
@@ -482,6 +502,8 @@ MVMint32 MVM_spesh_arg_guard_run(MVMThreadContext *tc, MVMSpeshArgGuard *ag,
     MVMObject *test = NULL;
     if (!ag)
         return -1;
+    if (ag->jitcode)
+        return ag->jitcode(tc, cs, args, ag->nodes);
     do {
         MVMSpeshArgGuardNode *agn = &(ag->nodes[current_node]);
         switch (agn->op) {
@@ -640,6 +662,8 @@ void MVM_spesh_arg_guard_destroy(MVMThreadContext *tc, MVMSpeshArgGuard *ag, MVM
     if (ag) {
         size_t total_size = sizeof(MVMSpeshArgGuard) +
             ag->num_nodes * sizeof(MVMSpeshArgGuardNode);
+        if (ag->jitcode)
+            MVM_jit_free_code(tc, (void *)ag->jitcode, ag->jitcode_size, safe);
         if (safe)
             MVM_fixed_size_free_at_safepoint(tc, tc->instance->fsa, total_size, ag);
         else
@@ -1,6 +1,11 @@
+/* Signature of an argument guard tree compiled into machine code. Returns
+ * the index of the selected specialization, or -1 if there is no match. */
+typedef MVMint32 (*MVMSpeshArgGuardJitFunc)(MVMThreadContext *tc, MVMCallsite *cs,
+        MVMRegister *args, MVMSpeshArgGuardNode *nodes);
+
 /* Specializations are selected using argument guards. These are arranged in
- * a tree, which is walked by a small interpreter. In the future, it may also
- * be compiled into machine code. */
+ * a tree, which is walked by a small interpreter or, when the JIT is enabled,
+ * compiled into machine code. */
 struct MVMSpeshArgGuard {
     /* The nodes making up the guard. */
     MVMSpeshArgGuardNode *nodes;
@@ -10,6 +15,11 @@ struct MVMSpeshArgGuard {
 
     /* How many nodes are actually used. */
     MVMuint32 used_nodes;
+
+    /* The compiled guard, if any, and the size of its code. The compiled
+     * code reads STables from the nodes, so it stays valid across GC. */
+    MVMSpeshArgGuardJitFunc jitcode;
+    size_t jitcode_size;
 };
 
 /* Operations we may perform when evaluating a guard. */
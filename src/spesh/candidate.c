@@ -19,6 +19,19 @@ static void calculate_work_env_sizes(MVMThreadContext *tc, MVMStaticFrame *sf,
     c->env_size = c->num_lexicals * sizeof(MVMRegister);
 }
 
+/* Estimates the memory held by a candidate, including its machine code. */
+static size_t candidate_memory_size(MVMThreadContext *tc, MVMSpeshCandidate *c) {
+    size_t size = sizeof(MVMSpeshCandidate) + c->bytecode_size
+        + sizeof(MVMFrameHandler) * c->num_handlers
+        + sizeof(MVMCollectable *) * c->num_spesh_slots
+        + sizeof(MVMint32) * 3 * c->num_deopts
+        + sizeof(MVMSpeshInline) * c->num_inlines
+        + sizeof(MVMuint16) * (c->num_locals + c->num_lexicals);
+    if (c->jitcode)
+        size += c->jitcode->size;
+    return size;
+}
+
 /* Called at points where we can GC safely during specialization. */
 static void spesh_gc_point(MVMThreadContext *tc) {
 #if MVM_GC_DEBUG
@@ -51,7 +64,18 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
 #if MVM_GC_DEBUG
     tc->in_spesh = 1;
 #endif
-    sg = MVM_spesh_graph_create(tc, p->sf, 0, 1);
+    if (p->is_region) {
+        sg = MVM_spesh_graph_create_region(tc, p->sf, p->region_osr_offset);
+        if (!sg) {
+#if MVM_GC_DEBUG
+            tc->in_spesh = 0;
+#endif
+            return;
+        }
+    }
+    else {
+        sg = MVM_spesh_graph_create(tc, p->sf, 0, 1);
+    }
     if (MVM_spesh_debug_enabled(tc)) {
         char *c_name = MVM_string_utf8_encode_C_string(tc, p->sf->body.name);
         char *c_cuid = MVM_string_utf8_encode_C_string(tc, p->sf->body.cuuid);
@@ -60,8 +84,13 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
         sg->facts = NULL;
         before = MVM_spesh_dump(tc, sg);
         sg->facts = facts;
-        MVM_spesh_debug_printf(tc,
-            "Specialization of '%s' (cuid: %s)\n\n", c_name, c_cuid);
+        if (sg->is_region)
+            MVM_spesh_debug_printf(tc,
+                "Specialization of loop at %u in '%s' (cuid: %s)\n\n",
+                sg->region_osr_offset, c_name, c_cuid);
+        else
+            MVM_spesh_debug_printf(tc,
+                "Specialization of '%s' (cuid: %s)\n\n", c_name, c_cuid);
         MVM_spesh_debug_printf(tc, "Before:\n%s", before);
         MVM_free(c_name);
         MVM_free(c_cuid);
@@ -77,7 +106,7 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
     spesh_gc_point(tc);
 
     /* Perform the optimization and, if we're logging, dump out the result. */
-    if (p->cs_stats->cs)
+    if (p->cs_stats->cs && !sg->is_region)
         MVM_spesh_args(tc, sg, p->cs_stats->cs, p->type_tuple);
     spesh_gc_point(tc);
     MVM_spesh_facts_discover(tc, sg, p, 0);
@@ -105,6 +134,9 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
     candidate->num_handlers  = sg->num_handlers;
     candidate->num_deopts    = sg->num_deopt_addrs;
     candidate->deopts        = sg->deopt_addrs;
+    candidate->deopt_point_counts = sg->num_deopt_addrs
+        ? MVM_calloc(sg->num_deopt_addrs, sizeof(MVMuint32))
+        : NULL;
     candidate->deopt_named_used_bit_field = sg->deopt_named_used_bit_field;
     candidate->deopt_pea     = sg->deopt_pea;
     candidate->num_locals    = sg->num_locals;
@@ -113,6 +145,10 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
     candidate->inlines       = sg->inlines;
     candidate->local_types   = sg->local_types;
     candidate->lexical_types = sg->lexical_types;
+    candidate->is_region     = sg->is_region;
+    candidate->region_osr_offset  = sg->region_osr_offset;
+    candidate->region_exits_start = sg->region_exits_start;
+    candidate->region_exits_end   = sg->region_exits_end;
 
     MVM_free(sc);
 
@@ -160,6 +196,23 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
     candidate->num_spesh_slots = sg->num_spesh_slots;
     candidate->spesh_slots     = sg->spesh_slots;
 
+    /* Add it to the candidates considered for eviction, counting it as used
+     * now so it isn't immediately evicted again. */
+    candidate->sf          = p->sf;
+    candidate->memory_size = candidate_memory_size(tc, candidate);
+    uv_mutex_lock(&(tc->instance->mutex_spesh_candidates));
+    candidate->last_used_epoch = tc->instance->spesh_eviction_epoch;
+    candidate->next_cand = tc->instance->spesh_candidates_head;
+    if (candidate->next_cand)
+        candidate->next_cand->prev_cand = candidate;
+    tc->instance->spesh_candidates_head = candidate;
+    tc->instance->spesh_memory_used += candidate->memory_size;
+    uv_mutex_unlock(&(tc->instance->mutex_spesh_candidates));
+
+    /* Unless evicted, the candidate lives as long as its static frame, which
+     * once in gen2 takes a full collection to free; count it towards one. */
+    MVM_add(&tc->instance->gc_promoted_bytes_since_last_full, candidate->memory_size);
+
     /* Claim ownership of allocated memory assigned to the candidate */
     sg->cand = candidate;
     MVM_spesh_graph_destroy(tc, sg);
@@ -210,13 +263,15 @@ void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p) {
 #endif
 }
 
-/* Frees the memory associated with a spesh candidate. */
-void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candidate) {
+/* Frees the memory associated with a spesh candidate, apart from the candidate
+ * itself. */
+static void release_candidate_memory(MVMThreadContext *tc, MVMSpeshCandidate *candidate) {
     MVM_free(candidate->type_tuple);
     MVM_free(candidate->bytecode);
     MVM_free(candidate->handlers);
     MVM_free(candidate->spesh_slots);
     MVM_free(candidate->deopts);
+    MVM_free(candidate->deopt_point_counts);
     MVM_spesh_pea_destroy_deopt_info(tc, &(candidate->deopt_pea));
     MVM_free(candidate->inlines);
     MVM_free(candidate->local_types);
@@ -224,6 +279,30 @@ void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candid
     if (candidate->jitcode)
         MVM_jit_code_destroy(tc, candidate->jitcode);
     MVM_free(candidate->deopt_usage_info);
+}
+
+/* Removes a candidate from the list of those considered for eviction. Must
+ * be called with mutex_spesh_candidates held. */
+static void unlink_candidate(MVMThreadContext *tc, MVMSpeshCandidate *candidate) {
+    if (candidate->prev_cand)
+        candidate->prev_cand->next_cand = candidate->next_cand;
+    else
+        tc->instance->spesh_candidates_head = candidate->next_cand;
+    if (candidate->next_cand)
+        candidate->next_cand->prev_cand = candidate->prev_cand;
+    candidate->prev_cand = candidate->next_cand = NULL;
+    if (candidate->eviction_state == MVM_SPESH_CANDIDATE_LIVE)
+        tc->instance->spesh_memory_used -= candidate->memory_size;
+}
+
+/* Frees the memory associated with a spesh candidate. */
+void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candidate) {
+    if (candidate->eviction_state != MVM_SPESH_CANDIDATE_RELEASED) {
+        uv_mutex_lock(&(tc->instance->mutex_spesh_candidates));
+        unlink_candidate(tc, candidate);
+        uv_mutex_unlock(&(tc->instance->mutex_spesh_candidates));
+        release_candidate_memory(tc, candidate);
+    }
     MVM_free(candidate);
 }
 
@@ -239,3 +318,104 @@ void MVM_spesh_candidate_discard_existing(MVMThreadContext *tc, MVMStaticFrame *
         MVM_spesh_arg_guard_discard(tc, sf);
     }
 }
+
+/* Evicts a candidate: it will no longer be selected, and its memory will be
+ * released once no frames are running it any more. */
+static void evict_candidate(MVMThreadContext *tc, MVMSpeshCandidate *cand) {
+    MVMStaticFrameSpesh *spesh = cand->sf->body.spesh;
+    tc->instance->spesh_memory_used -= cand->memory_size;
+    cand->eviction_state    = MVM_SPESH_CANDIDATE_EVICTED;
+    cand->last_seen_full_gc = (MVMuint32)MVM_load(&(tc->instance->gc_full_seq_number));
+    if (!cand->discarded) {
+        cand->discarded = 1;
+        MVM_spesh_arg_guard_regenerate(tc, &(spesh->body.spesh_arg_guard),
+            spesh->body.spesh_candidates, spesh->body.num_spesh_candidates);
+    }
+    if (MVM_spesh_debug_enabled(tc)) {
+        char *c_name = MVM_string_utf8_encode_C_string(tc, cand->sf->body.name);
+        char *c_cuid = MVM_string_utf8_encode_C_string(tc, cand->sf->body.cuuid);
+        MVM_spesh_debug_printf(tc,
+            "Evicted a specialization of '%s' (cuid: %s), freeing %" PRIu64 " bytes; "
+            "it was used %u times\n\n",
+            c_name, c_cuid, (MVMuint64)cand->memory_size, cand->usage_count);
+        MVM_free(c_name);
+        MVM_free(c_cuid);
+    }
+}
+
+/* Orders candidates by when they were last seen being used, oldest first. */
+static int cmp_last_used(const void *a, const void *b) {
+    MVMuint32 x = (*(MVMSpeshCandidate **)a)->last_used_epoch;
+    MVMuint32 y = (*(MVMSpeshCandidate **)b)->last_used_epoch;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/* Called by the specialization worker after it has installed a batch of
+ * candidates. Notes which candidates were used since the last time, releases
+ * the memory of evicted candidates no frame has referenced for two full GC
+ * runs, evicts any discarded candidates, and then evicts the least recently
+ * used candidates until we are back within the memory budget. */
+void MVM_spesh_candidate_evict(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    MVMSpeshCandidate *cand, *next;
+    MVMuint32 epoch, full_gc;
+
+    uv_mutex_lock(&(instance->mutex_spesh_candidates));
+    epoch   = ++instance->spesh_eviction_epoch;
+    full_gc = (MVMuint32)MVM_load(&(instance->gc_full_seq_number));
+    for (cand = instance->spesh_candidates_head; cand; cand = next) {
+        next = cand->next_cand;
+        if (cand->eviction_state == MVM_SPESH_CANDIDATE_EVICTED) {
+            if (full_gc - cand->last_seen_full_gc >= 2) {
+                unlink_candidate(tc, cand);
+                release_candidate_memory(tc, cand);
+                cand->type_tuple = NULL;
+                cand->bytecode = NULL;
+                cand->bytecode_size = 0;
+                cand->handlers = NULL;
+                cand->num_handlers = 0;
+                cand->spesh_slots = NULL;
+                cand->num_spesh_slots = 0;
+                cand->deopts = NULL;
+                cand->deopt_point_counts = NULL;
+                cand->num_deopts = 0;
+                cand->inlines = NULL;
+                cand->num_inlines = 0;
+                cand->local_types = NULL;
+                cand->lexical_types = NULL;
+                cand->jitcode = NULL;
+                cand->deopt_usage_info = NULL;
+                cand->eviction_state = MVM_SPESH_CANDIDATE_RELEASED;
+            }
+        }
+        else if (cand->discarded) {
+            evict_candidate(tc, cand);
+        }
+        else if (cand->usage_count != cand->usage_count_seen) {
+            cand->usage_count_seen = cand->usage_count;
+            cand->last_used_epoch  = epoch;
+        }
+    }
+
+    /* If over budget, collect the candidates not used since the last time,
+     * and evict them least recently used first until within it again. */
+    if (instance->spesh_memory_limit && instance->spesh_memory_used > instance->spesh_memory_limit) {
+        MVMSpeshCandidate **coldest;
+        MVMuint32 num_coldest = 0, i;
+        for (cand = instance->spesh_candidates_head; cand; cand = cand->next_cand)
+            if (cand->eviction_state == MVM_SPESH_CANDIDATE_LIVE && cand->last_used_epoch != epoch)
+                num_coldest++;
+        if (num_coldest) {
+            coldest = MVM_malloc(num_coldest * sizeof(MVMSpeshCandidate *));
+            i = 0;
+            for (cand = instance->spesh_candidates_head; cand; cand = cand->next_cand)
+                if (cand->eviction_state == MVM_SPESH_CANDIDATE_LIVE && cand->last_used_epoch != epoch)
+                    coldest[i++] = cand;
+            qsort(coldest, num_coldest, sizeof(MVMSpeshCandidate *), cmp_last_used);
+            for (i = 0; i < num_coldest && instance->spesh_memory_used > instance->spesh_memory_limit; i++)
+                evict_candidate(tc, coldest[i]);
+            MVM_free(coldest);
+        }
+    }
+    uv_mutex_unlock(&(instance->mutex_spesh_candidates));
+}
@@ -1,3 +1,15 @@
+/* The default budget, in megabytes, for the memory held by specializations
+ * and their machine code; see MVM_SPESH_MEMORY_LIMIT. */
+#define MVM_SPESH_DEFAULT_MEMORY_LIMIT 256
+
+/* Eviction states of a specialization candidate. An evicted candidate is no
+ * longer selected, but may still be running; once no frame has referenced it
+ * for two full GC runs, its memory is released, leaving only the candidate
+ * itself in place so the indexes of its siblings stay valid. */
+#define MVM_SPESH_CANDIDATE_LIVE     0
+#define MVM_SPESH_CANDIDATE_EVICTED  1
+#define MVM_SPESH_CANDIDATE_RELEASED 2
+
 /* A specialization candidate. */
 struct MVMSpeshCandidate {
     /* The callsite that this specialization is for. */
@@ -31,6 +43,12 @@ struct MVMSpeshCandidate {
     /* Deoptimization mappings. */
     MVMint32 *deopts;
 
+    /* Number of times a deopt_one has happened in this candidate, in total
+     * and per deopt point (same indexing as deopts). Used to spot deopt
+     * storms. Allowed to be a bit racey between threads. */
+    MVMuint32 deopt_count;
+    MVMuint32 *deopt_point_counts;
+
     /* Bit field of named args used to put in place during deopt, since we
      * typically don't update the array in specialized code. */
     MVMuint64 deopt_named_used_bit_field;
@@ -66,6 +84,33 @@ struct MVMSpeshCandidate {
     /* JIT-code structure. */
     MVMJitCode *jitcode;
 
+    /* The static frame this is a specialization of. */
+    MVMStaticFrame *sf;
+
+    /* Number of times this candidate was picked on invocation or for OSR.
+     * Allowed to be racey between threads. */
+    MVMuint32 usage_count;
+
+    /* Eviction bookkeeping. These are protected by the instance's
+     * mutex_spesh_candidates, apart from last_seen_full_gc, which the GC
+     * updates when it sees a frame running an evicted candidate. */
+    MVMuint8 eviction_state;
+    MVMuint32 usage_count_seen;
+    MVMuint32 last_used_epoch;
+    MVMuint32 last_seen_full_gc;
+    size_t memory_size;
+    MVMSpeshCandidate *prev_cand;
+    MVMSpeshCandidate *next_cand;
+
+    /* Set if this candidate only covers the loop headed by the OSR point at
+     * region_osr_offset, in which case it can only be entered by OSR there.
+     * The deopt indexes from region_exits_start up to region_exits_end are
+     * the exits of the loop, where we always deopt. */
+    MVMuint8 is_region;
+    MVMuint32 region_osr_offset;
+    MVMuint32 region_exits_start;
+    MVMuint32 region_exits_end;
+
     /* Information used to reconstruct deoptimization usage info should we do
      * an inline of this candidate. It's stored as a sequence of integers of
      * the form:
@@ -81,3 +126,4 @@ struct MVMSpeshCandidate {
 void MVM_spesh_candidate_add(MVMThreadContext *tc, MVMSpeshPlanned *p);
 void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candidate);
 void MVM_spesh_candidate_discard_existing(MVMThreadContext *tc, MVMStaticFrame *sf);
+void MVM_spesh_candidate_evict(MVMThreadContext *tc);
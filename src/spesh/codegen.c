@@ -295,6 +295,9 @@ static void write_instructions(MVMThreadContext *tc, MVMSpeshGraph *g, SpeshWrit
             case MVM_OP_sp_guardjusttype:
                 deopt_idx = ins->operands[2].lit_ui32;
                 break;
+            case MVM_OP_sp_deopt:
+                deopt_idx = ins->operands[0].lit_ui32;
+                break;
             default:
                 deopt_idx = -1;
                 break;
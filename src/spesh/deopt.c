@@ -277,6 +277,42 @@ static void deopt_frame(MVMThreadContext *tc, MVMFrame *f, MVMuint32 deopt_idx,
     }
 }
 
+/* Counts a deopt_one in a specialization. If a deopt point has failed often
+ * enough, we consider it a deopt storm and log it for the specialization
+ * worker, which will throw the candidate away and re-plan it without the
+ * guard in question. We log it again each further threshold deopts, in case
+ * the thread had no spesh log to hand at the time. */
+static void count_deopt(MVMThreadContext *tc, MVMFrame *f, MVMuint32 deopt_idx,
+                        MVMuint32 deopt_offset, MVMuint32 deopt_target) {
+    MVMSpeshCandidate *cand = f->spesh_cand;
+
+    /* Leaving a loop region is expected, not a sign of a bad guard. */
+    if (cand->is_region && deopt_idx >= cand->region_exits_start &&
+            deopt_idx < cand->region_exits_end)
+        return;
+
+    cand->deopt_count++;
+    if (++cand->deopt_point_counts[deopt_idx] % MVM_SPESH_DEOPT_STORM_THRESHOLD == 0) {
+        /* If the deopt is in an inline, the deopt target is in the bytecode
+         * of the innermost inlined frame. */
+        MVMStaticFrame *guard_sf = f->static_info;
+        MVMuint32 i;
+        if (!tc->spesh_log || cand->discarded)
+            return;
+        for (i = 0; i < cand->num_inlines; i++) {
+            if (deopt_offset > cand->inlines[i].start && deopt_offset <= cand->inlines[i].end) {
+                guard_sf = cand->inlines[i].sf;
+                break;
+            }
+        }
+#if MVM_LOG_DEOPTS
+        fprintf(stderr, "    Deopt storm at %u (%u deopts in candidate)\n",
+            deopt_target, cand->deopt_count);
+#endif
+        MVM_spesh_log_deopt_storm(tc, f->static_info, cand, guard_sf, deopt_target);
+    }
+}
+
 /* De-optimizes the currently executing frame, provided it is specialized and
  * at a valid de-optimization point. Typically used when a guard fails. */
 void MVM_spesh_deopt_one(MVMThreadContext *tc, MVMuint32 deopt_idx) {
@@ -297,6 +333,7 @@ void MVM_spesh_deopt_one(MVMThreadContext *tc, MVMuint32 deopt_idx) {
 #if MVM_LOG_DEOPTS
         fprintf(stderr, "    Will deopt %u -> %u\n", deopt_offset, deopt_target);
 #endif
+        count_deopt(tc, f, deopt_idx, deopt_offset, deopt_target);
         deopt_frame(tc, tc->cur_frame, deopt_idx, deopt_offset, deopt_target);
     }
     else {
@@ -415,3 +452,94 @@ void MVM_spesh_deopt_all(MVMThreadContext *tc) {
     fprintf(stderr, "Deopt all completed\n");
 #endif
 }
+
+/* Checks if a logged guard at the specified deopt target in a static frame's
+ * bytecode caused a deopt storm before, meaning we should not guard on the
+ * logged type there again. */
+MVMint32 MVM_spesh_deopt_storm_seen(MVMThreadContext *tc, MVMStaticFrame *sf,
+                                    MVMuint32 deopt_target) {
+    MVMStaticFrameSpesh *spesh = sf->body.spesh;
+    MVMuint32 i;
+    for (i = 0; i < spesh->body.num_deopt_storm_offsets; i++)
+        if (spesh->body.deopt_storm_offsets[i] == deopt_target)
+            return 1;
+    return 0;
+}
+
+/* Discards any specializations of a frame that contain a guard deopting to
+ * the specified deopt target. Used when a deopt storm happened in an inline,
+ * since the inlinee's own candidate still has the failing guard and would
+ * otherwise just be inlined again. */
+static void discard_guarding_candidates(MVMThreadContext *tc, MVMStaticFrame *sf,
+                                        MVMuint32 deopt_target) {
+    MVMStaticFrameSpesh *spesh = sf->body.spesh;
+    MVMuint32 discarded = 0;
+    MVMuint32 i, j;
+    for (i = 0; i < spesh->body.num_spesh_candidates; i++) {
+        MVMSpeshCandidate *cand = spesh->body.spesh_candidates[i];
+        if (cand->discarded)
+            continue;
+        for (j = 0; j < cand->num_deopts; j++) {
+            if ((MVMuint32)cand->deopts[2 * j] == deopt_target) {
+                cand->discarded = 1;
+                discarded = 1;
+                break;
+            }
+        }
+    }
+    if (discarded)
+        MVM_spesh_arg_guard_regenerate(tc, &(spesh->body.spesh_arg_guard),
+            spesh->body.spesh_candidates, spesh->body.num_spesh_candidates);
+}
+
+/* Handles a deopt storm logged by the interpreter. Runs on the specialization
+ * worker thread. Records the deopt target so that the next specialization
+ * will leave the failing guard out, discards the candidate, and regenerates
+ * the argument guard so it is no longer selected. If the storm was in an
+ * inline, the inlinee's candidates with the guard are discarded too. Returns
+ * non-zero if the candidate was discarded, meaning the static frame should be
+ * planned for again. */
+MVMint32 MVM_spesh_deopt_storm(MVMThreadContext *tc, MVMStaticFrame *sf,
+                               MVMSpeshCandidate *cand, MVMStaticFrame *guard_sf,
+                               MVMuint32 deopt_target) {
+    MVMStaticFrameSpesh *spesh = sf->body.spesh;
+    MVMStaticFrameSpesh *guard_spesh = guard_sf->body.spesh;
+
+    /* Already dealt with, or given up on re-specializing this frame? */
+    if (cand->discarded || spesh->body.num_deopt_storms >= MVM_SPESH_DEOPT_STORM_MAX)
+        return 0;
+    spesh->body.num_deopt_storms++;
+
+    /* Record the deopt target as one to not guard on in the future. */
+    if (!MVM_spesh_deopt_storm_seen(tc, guard_sf, deopt_target)) {
+        guard_spesh->body.deopt_storm_offsets = MVM_realloc(
+            guard_spesh->body.deopt_storm_offsets,
+            (guard_spesh->body.num_deopt_storm_offsets + 1) * sizeof(MVMuint32));
+        guard_spesh->body.deopt_storm_offsets[guard_spesh->body.num_deopt_storm_offsets++]
+            = deopt_target;
+    }
+
+    /* Discard the candidate and rebuild the guard tree without it. */
+    cand->discarded = 1;
+    MVM_spesh_arg_guard_regenerate(tc, &(spesh->body.spesh_arg_guard),
+        spesh->body.spesh_candidates, spesh->body.num_spesh_candidates);
+    if (guard_sf != sf)
+        discard_guarding_candidates(tc, guard_sf, deopt_target);
+
+    if (MVM_spesh_debug_enabled(tc)) {
+        char *c_name = MVM_string_utf8_encode_C_string(tc, sf->body.name);
+        char *c_cuid = MVM_string_utf8_encode_C_string(tc, sf->body.cuuid);
+        char *c_guard_name = MVM_string_utf8_encode_C_string(tc, guard_sf->body.name);
+        MVM_spesh_debug_printf(tc,
+            "Deopt Storm\n"
+            "===========\n"
+            "Discarded a specialization of '%s' (cuid: %s) after %u deopts; "
+            "will no longer guard at offset %u of '%s'.\n\n",
+            c_name, c_cuid, cand->deopt_count, deopt_target, c_guard_name);
+        MVM_free(c_name);
+        MVM_free(c_cuid);
+        MVM_free(c_guard_name);
+    }
+
+    return 1;
+}
@@ -1,3 +1,16 @@
+/* The number of times a single deopt point in a specialization must fail
+ * before we consider it a deopt storm, throw away the specialization, and
+ * plan a new one without the failing guard. */
+#define MVM_SPESH_DEOPT_STORM_THRESHOLD 1000
+
+/* The maximum number of times we will throw away specializations of a frame
+ * due to deopt storms, to avoid thrashing. */
+#define MVM_SPESH_DEOPT_STORM_MAX 8
+
 void MVM_spesh_deopt_all(MVMThreadContext *tc);
 void MVM_spesh_deopt_one(MVMThreadContext *tc, MVMuint32 deopt_idx);
 MVMint32 MVM_spesh_deopt_find_inactive_frame_deopt_idx(MVMThreadContext *tc, MVMFrame *f);
+MVMint32 MVM_spesh_deopt_storm_seen(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMuint32 deopt_target);
+MVMint32 MVM_spesh_deopt_storm(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMSpeshCandidate *cand, MVMStaticFrame *guard_sf, MVMuint32 deopt_target);
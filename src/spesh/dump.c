@@ -335,7 +335,7 @@ static void dump_bb(MVMThreadContext *tc, DumpStr *ds, MVMSpeshGraph *g, MVMSpes
                             size += 2;
                             break;
                         case MVM_operand_coderef: {
-                            MVMCodeBody *body = &((MVMCode*)g->sf->body.cu->body.coderefs[cur_ins->operands[i].coderef_idx])->body;
+                            MVMCodeBody *body = &((MVMCode*)MVM_cu_coderef(tc, g->sf->body.cu, cur_ins->operands[i].coderef_idx))->body;
                             MVMBytecodeAnnotation *anno = MVM_bytecode_resolve_annotation(tc, &body->sf->body, 0);
 
                             append(ds, "coderef(");
@@ -784,6 +784,32 @@ void dump_stats_by_callsite(MVMThreadContext *tc, DumpStr *ds, MVMSpeshStatsByCa
     }
 }
 
+/* Dumps the deoptimization counters of the specializations of a frame, so
+ * that deopt storms can be spotted. */
+static void dump_deopt_counts(MVMThreadContext *tc, DumpStr *ds, MVMStaticFrame *sf) {
+    MVMStaticFrameSpesh *spesh = sf->body.spesh;
+    MVMuint32 i, j;
+    if (spesh->body.num_deopt_storms)
+        appendf(ds, "\nDeopt storms: %u\n", spesh->body.num_deopt_storms);
+    if (spesh->body.num_deopt_storm_offsets) {
+        append(ds, "Unguarded due to deopt storms at offsets:");
+        for (i = 0; i < spesh->body.num_deopt_storm_offsets; i++)
+            appendf(ds, " %u", spesh->body.deopt_storm_offsets[i]);
+        append(ds, "\n");
+    }
+    for (i = 0; i < spesh->body.num_spesh_candidates; i++) {
+        MVMSpeshCandidate *cand = spesh->body.spesh_candidates[i];
+        if (!cand->deopt_count)
+            continue;
+        appendf(ds, "\nCandidate %u%s deopted %u times\n", i,
+            cand->discarded ? " (discarded)" : "", cand->deopt_count);
+        for (j = 0; j < cand->num_deopts; j++)
+            if (cand->deopt_point_counts[j])
+                appendf(ds, "    - deopt point %u (to offset %d): %u\n", j,
+                    cand->deopts[2 * j], cand->deopt_point_counts[j]);
+    }
+}
+
 /* Dumps the statistics associated with a static frame into a string. */
 char * MVM_spesh_dump_stats(MVMThreadContext *tc, MVMStaticFrame *sf) {
     MVMSpeshStats *ss = sf->body.spesh->body.spesh_stats;
@@ -827,6 +853,8 @@ char * MVM_spesh_dump_stats(MVMThreadContext *tc, MVMStaticFrame *sf) {
         append(&ds, "No spesh stats for this static frame\n");
     }
 
+    dump_deopt_counts(tc, &ds, sf);
+
     append(&ds, "\n");
     append_null(&ds);
     return ds.buffer;
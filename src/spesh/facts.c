@@ -286,6 +286,13 @@ static void log_facts(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
     MVMuint32 agg_type_object = 0;
     MVMuint32 agg_concrete = 0;
     MVMuint32 i;
+
+    /* If a guard here caused a deopt storm in an earlier specialization,
+     * don't trust the logged types; leave the value unguarded instead. */
+    if (MVM_spesh_deopt_storm_seen(tc, g->sf,
+            g->deopt_addrs[2 * deopt_one_ann->data.deopt_idx]))
+        return;
+
     for (i = 0; i < p->num_type_stats; i++) {
         MVMSpeshStatsByType *ts = p->type_stats[i];
         MVMuint32 j;
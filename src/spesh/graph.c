@@ -39,7 +39,9 @@ void * MVM_spesh_alloc(MVMThreadContext *tc, MVMSpeshGraph *g, size_t bytes) {
  * that already pass validation. */
 static const MVMOpInfo * get_op_info(MVMThreadContext *tc, MVMCompUnit *cu, MVMuint16 opcode) {
     if (opcode < MVM_OP_EXT_BASE) {
-        return MVM_op_get_op(opcode);
+        /* Superinstructions are read as their first op; the second one
+         * follows with its own opcode. */
+        return MVM_op_get_op(MVM_validate_unfuse_op(opcode));
     }
     else {
         MVMuint16       index  = opcode - MVM_OP_EXT_BASE;
@@ -204,7 +206,9 @@ static void build_cfg(MVMThreadContext *tc, MVMSpeshGraph *g, MVMStaticFrame *sf
     }
     while (pc < end) {
         /* Look up op info. */
-        MVMuint16  opcode     = *(MVMuint16 *)pc;
+        MVMuint16  opcode     = *(MVMuint16 *)pc == MVM_OP_sp_predecoded
+            ? MVM_predecode_orig_op(tc, sf, pc - g->bytecode)
+            : *(MVMuint16 *)pc;
         MVMuint8  *args       = pc + 2;
         MVMuint8   arg_size   = 0;
         const MVMOpInfo *info = get_op_info(tc, cu, opcode);
@@ -371,6 +375,7 @@ static void build_cfg(MVMThreadContext *tc, MVMSpeshGraph *g, MVMStaticFrame *sf
         case MVM_OP_invoke_n:
         case MVM_OP_invoke_s:
         case MVM_OP_invoke_o:
+        case MVM_OP_sp_tailinvoke_o:
         case MVM_OP_return_i:
         case MVM_OP_return_n:
         case MVM_OP_return_s:
@@ -691,6 +696,7 @@ static void build_cfg(MVMThreadContext *tc, MVMSpeshGraph *g, MVMStaticFrame *sf
                     || cur_bb->last_ins->info->opcode == MVM_OP_invoke_n
                     || cur_bb->last_ins->info->opcode == MVM_OP_invoke_s
                     || cur_bb->last_ins->info->opcode == MVM_OP_invoke_o
+                    || cur_bb->last_ins->info->opcode == MVM_OP_sp_tailinvoke_o
                 )
             ) {
                 cur_bb->handler_succ = MVM_spesh_alloc(tc, g, num_active_handlers * sizeof(MVMSpeshBB *));
@@ -793,6 +799,158 @@ static void insert_object_null_instructions(MVMThreadContext *tc, MVMSpeshGraph
     }
 }
 
+/* Turns a basic block at an exit of a loop region into one that does nothing
+ * but deoptimize to the start of the block in the original bytecode. Any
+ * handler and line number annotations are kept on the deopt instruction. */
+static void make_region_exit(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb) {
+    MVMSpeshIns *deopt_ins = MVM_spesh_alloc(tc, g, sizeof(MVMSpeshIns));
+    MVMSpeshIns *ins       = bb->first_ins;
+    deopt_ins->info        = MVM_op_get_op(MVM_OP_sp_deopt);
+    deopt_ins->operands    = MVM_spesh_alloc(tc, g, sizeof(MVMSpeshOperand));
+    while (ins) {
+        MVMSpeshAnn *ann = ins->annotations;
+        while (ann) {
+            MVMSpeshAnn *next_ann = ann->next;
+            switch (ann->type) {
+                case MVM_SPESH_ANN_FH_START:
+                case MVM_SPESH_ANN_FH_END:
+                case MVM_SPESH_ANN_FH_GOTO:
+                case MVM_SPESH_ANN_LINENO:
+                    ann->next = deopt_ins->annotations;
+                    deopt_ins->annotations = ann;
+                    break;
+            }
+            ann = next_ann;
+        }
+        ins = ins->next;
+    }
+    deopt_ins->operands[0].lit_ui32 = MVM_spesh_graph_add_deopt_annotation(tc, g,
+        deopt_ins, bb->initial_pc, MVM_SPESH_ANN_DEOPT_ONE_INS);
+    bb->first_ins        = deopt_ins;
+    bb->last_ins         = deopt_ins;
+    bb->succ             = NULL;
+    bb->num_succ         = 0;
+    bb->handler_succ     = NULL;
+    bb->num_handler_succ = 0;
+}
+
+/* Restricts the CFG to the loop headed by the OSR point at the specified
+ * offset. The loop is made up of the blocks that can be reached from the
+ * OSR point and can reach it again. Blocks outside of the loop that it may
+ * branch to, or that catch handlers may go to, become deopts to the original
+ * bytecode; the rest become unreachable, and are thrown out by dead BB
+ * elimination afterwards. Returns zero if there's no such OSR point. */
+static MVMint32 restrict_to_region(MVMThreadContext *tc, MVMSpeshGraph *g, MVMuint32 osr_offset) {
+    MVMSpeshBB  *header    = NULL;
+    MVMSpeshBB  *cur_bb;
+    MVMSpeshBB **worklist;
+    MVMSpeshBB **catch_bbs;
+    MVMuint8    *reachable, *in_loop, *is_exit;
+    MVMuint32    num_worklist = 0;
+    MVMuint32    num_catch_bbs = 0;
+    MVMuint32    changed, i;
+
+    /* Find the loop header. */
+    cur_bb = g->entry->linear_next;
+    while (cur_bb) {
+        if (cur_bb->first_ins->info->opcode == MVM_OP_osrpoint &&
+                cur_bb->initial_pc == osr_offset) {
+            header = cur_bb;
+            break;
+        }
+        cur_bb = cur_bb->linear_next;
+    }
+    if (!header)
+        return 0;
+
+    /* Find everything reachable from the header. */
+    worklist  = MVM_malloc(g->num_bbs * sizeof(MVMSpeshBB *));
+    reachable = MVM_calloc(g->num_bbs, 1);
+    in_loop   = MVM_calloc(g->num_bbs, 1);
+    is_exit   = MVM_calloc(g->num_bbs, 1);
+    reachable[header->idx] = 1;
+    worklist[num_worklist++] = header;
+    while (num_worklist) {
+        MVMSpeshBB *bb = worklist[--num_worklist];
+        for (i = 0; i < bb->num_succ; i++) {
+            if (!reachable[bb->succ[i]->idx]) {
+                reachable[bb->succ[i]->idx] = 1;
+                worklist[num_worklist++] = bb->succ[i];
+            }
+        }
+    }
+
+    /* Of those, the loop is the blocks that can get back to the header. */
+    in_loop[header->idx] = 1;
+    do {
+        changed = 0;
+        cur_bb = g->entry->linear_next;
+        while (cur_bb) {
+            if (reachable[cur_bb->idx] && !in_loop[cur_bb->idx]) {
+                for (i = 0; i < cur_bb->num_succ; i++) {
+                    if (in_loop[cur_bb->succ[i]->idx]) {
+                        in_loop[cur_bb->idx] = 1;
+                        changed = 1;
+                        break;
+                    }
+                }
+            }
+            cur_bb = cur_bb->linear_next;
+        }
+    } while (changed);
+
+    /* Jump lists must be followed by all of their goto blocks. */
+    cur_bb = g->entry->linear_next;
+    while (cur_bb) {
+        if (in_loop[cur_bb->idx] && cur_bb->last_ins->info->opcode == MVM_OP_jumplist)
+            for (i = 0; i < cur_bb->num_succ; i++)
+                in_loop[cur_bb->succ[i]->idx] = 1;
+        cur_bb = cur_bb->linear_next;
+    }
+
+    /* Find the exits, and the catch handler targets (which come right after
+     * the real successor in the entry block's successors). */
+    cur_bb = g->entry->linear_next;
+    while (cur_bb) {
+        if (in_loop[cur_bb->idx])
+            for (i = 0; i < cur_bb->num_succ; i++)
+                if (!in_loop[cur_bb->succ[i]->idx])
+                    is_exit[cur_bb->succ[i]->idx] = 1;
+        cur_bb = cur_bb->linear_next;
+    }
+    catch_bbs = MVM_spesh_alloc(tc, g, (1 + g->num_handlers) * sizeof(MVMSpeshBB *));
+    catch_bbs[num_catch_bbs++] = header;
+    for (i = 0; i < g->num_handlers; i++) {
+        if (is_catch_handler(tc, g, i) && g->handlers[i].goto_offset != (MVMuint32)-1) {
+            MVMSpeshBB *catch_bb = g->entry->succ[num_catch_bbs];
+            if (!in_loop[catch_bb->idx])
+                is_exit[catch_bb->idx] = 1;
+            catch_bbs[num_catch_bbs++] = catch_bb;
+        }
+    }
+
+    /* Turn the exits into deopts, and make the header and the catch targets
+     * the only ways into the graph. */
+    g->region_exits_start = g->num_deopt_addrs;
+    cur_bb = g->entry->linear_next;
+    while (cur_bb) {
+        if (is_exit[cur_bb->idx])
+            make_region_exit(tc, g, cur_bb);
+        cur_bb = cur_bb->linear_next;
+    }
+    g->region_exits_end  = g->num_deopt_addrs;
+    g->entry->succ       = catch_bbs;
+    g->entry->num_succ   = num_catch_bbs;
+    g->is_region         = 1;
+    g->region_osr_offset = osr_offset;
+
+    MVM_free(worklist);
+    MVM_free(reachable);
+    MVM_free(in_loop);
+    MVM_free(is_exit);
+    return 1;
+}
+
 /* Annotates the control flow graph with predecessors. */
 static void add_predecessors(MVMThreadContext *tc, MVMSpeshGraph *g) {
     MVMSpeshBB *cur_bb = g->entry;
@@ -1323,6 +1481,51 @@ MVMSpeshGraph * MVM_spesh_graph_create(MVMThreadContext *tc, MVMStaticFrame *sf,
     return g;
 }
 
+/* Takes a static frame that is too big to be optimized as a whole and creates
+ * a spesh graph for just the loop headed by the OSR point at the specified
+ * offset. Returns NULL if there is no such loop. */
+MVMSpeshGraph * MVM_spesh_graph_create_region(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMuint32 osr_offset) {
+    MVMuint32 i, j;
+
+    /* Create top-level graph object. */
+    MVMSpeshGraph *g = MVM_calloc(1, sizeof(MVMSpeshGraph));
+    g->sf            = sf;
+    g->bytecode      = sf->body.bytecode;
+    g->bytecode_size = sf->body.bytecode_size;
+    g->handlers      = sf->body.handlers;
+    g->num_handlers  = sf->body.num_handlers;
+    g->num_locals    = sf->body.num_locals;
+    g->num_lexicals  = sf->body.num_lexicals;
+    g->phi_infos     = MVM_spesh_alloc(tc, g, MVMPhiNodeCacheSize * sizeof(MVMOpInfo));
+
+    /* Ensure the frame is validated, since we'll rely on this. */
+    if (sf->body.instrumentation_level == 0) {
+        MVM_spesh_graph_destroy(tc, g);
+        MVM_oops(tc, "Spesh: cannot build CFG from unvalidated frame");
+    }
+
+    /* Build the CFG, cut it down to the region, and transform it to SSA. We
+     * never enter at the top of the frame, so there's no object nulling. */
+    build_cfg(tc, g, sf, NULL, 0, NULL, NULL);
+    if (!restrict_to_region(tc, g, osr_offset)) {
+        MVM_spesh_graph_destroy(tc, g);
+        return NULL;
+    }
+    MVM_spesh_eliminate_dead_bbs(tc, g, 0);
+    add_predecessors(tc, g);
+    ssa(tc, g);
+
+    /* Values may be read by the original bytecode after any of the exits,
+     * which we can't see, so everything must be kept for deopt. */
+    for (i = 0; i < g->num_locals; i++)
+        for (j = 0; j < g->fact_counts[i]; j++)
+            MVM_spesh_usages_add_unconditional_deopt_usage(tc, g, &(g->facts[i][j]));
+
+    /* Hand back the completed graph. */
+    return g;
+}
+
 /* Takes a static frame and creates a spesh graph for it. */
 MVMSpeshGraph * MVM_spesh_graph_create_from_cand(MVMThreadContext *tc, MVMStaticFrame *sf,
                                                  MVMSpeshCandidate *cand, MVMuint32 cfg_only,
@@ -111,6 +111,14 @@ struct MVMSpeshGraph {
      * original static frame, the candidate will be stored here. */
     MVMSpeshCandidate *cand;
 
+    /* If this graph only covers a loop region of the frame, entered by OSR
+     * at region_osr_offset, this is set. The deopt indexes in the range from
+     * region_exits_start up to region_exits_end are the region exits. */
+    MVMuint8 is_region;
+    MVMuint32 region_osr_offset;
+    MVMuint32 region_exits_start;
+    MVMuint32 region_exits_end;
+
     /* Did we specialize on the invocant type? */
     MVMuint8 specialized_on_invocant;
 
@@ -282,6 +290,8 @@ struct MVMSpeshAnn {
 /* Functions to create/destroy the spesh graph. */
 MVMSpeshGraph * MVM_spesh_graph_create(MVMThreadContext *tc, MVMStaticFrame *sf,
     MVMuint32 cfg_only, MVMuint32 insert_object_nulls);
+MVMSpeshGraph * MVM_spesh_graph_create_region(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMuint32 osr_offset);
 MVMSpeshGraph * MVM_spesh_graph_create_from_cand(MVMThreadContext *tc, MVMStaticFrame *sf,
     MVMSpeshCandidate *cand, MVMuint32 cfg_only, MVMSpeshIns ***deopt_usage_ins_out);
 MVMSpeshBB * MVM_spesh_graph_linear_prev(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *search);
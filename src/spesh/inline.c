@@ -536,6 +536,9 @@ static void tweak_guard_deopt_idx(MVMSpeshIns *ins, MVMSpeshAnn *ann) {
     case MVM_OP_sp_guardjusttype:
         ins->operands[2].lit_ui32 = ann->data.deopt_idx;
         break;
+    case MVM_OP_sp_deopt:
+        ins->operands[0].lit_ui32 = ann->data.deopt_idx;
+        break;
     default:
         break;
     }
@@ -672,6 +675,10 @@ static MVMSpeshBB * merge_graph(MVMThreadContext *tc, MVMSpeshGraph *inliner,
                 }
             }
             else {
+                /* A tail call in the inlinee is not one in the inliner. */
+                if (opcode == MVM_OP_sp_tailinvoke_o)
+                    ins->info = MVM_op_get_op(MVM_OP_invoke_o);
+
                 if (!same_comp_unit) {
                     if (ins->info->opcode == MVM_OP_const_s) {
                         fix_const_str(tc, inliner, inlinee, ins);
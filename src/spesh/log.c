@@ -250,3 +250,19 @@ void MVM_spesh_log_plugin_resolution(MVMThreadContext *tc, MVMuint32 bytecode_of
     entry->plugin.guard_index = guard_index;
     commit_entry(tc, sl);
 }
+
+/* Log that a specialization suffered a deopt storm at a particular deopt
+ * target, so that the worker can throw it away and re-plan it. */
+void MVM_spesh_log_deopt_storm(MVMThreadContext *tc, MVMStaticFrame *sf,
+                               MVMSpeshCandidate *cand, MVMStaticFrame *guard_sf,
+                               MVMuint32 deopt_target) {
+    MVMSpeshLog *sl = tc->spesh_log;
+    MVMSpeshLogEntry *entry = &(sl->body.entries[sl->body.used]);
+    entry->kind = MVM_SPESH_LOG_DEOPT_STORM;
+    entry->id = 0;
+    MVM_ASSIGN_REF(tc, &(sl->common.header), entry->deopt.sf, sf);
+    entry->deopt.cand = cand;
+    MVM_ASSIGN_REF(tc, &(sl->common.header), entry->deopt.guard_sf, guard_sf);
+    entry->deopt.deopt_target = deopt_target;
+    commit_entry(tc, sl);
+}
@@ -1556,6 +1556,8 @@ static MVMint32 try_find_spesh_candidate(MVMThreadContext *tc, MVMStaticFrame *s
                                          MVMSpeshCallInfo *arg_info,
                                          MVMSpeshStatsType *type_tuple) {
     MVMSpeshArgGuard *ag = sf->body.spesh->body.spesh_arg_guard;
+    if (sf->body.bytecode_size > MVM_SPESH_MAX_BYTECODE_SIZE)
+        return -1; /* Only has loop region candidates. */
     return type_tuple
         ? MVM_spesh_arg_guard_run_types(tc, ag, arg_info->cs, type_tuple)
         : MVM_spesh_arg_guard_run_callinfo(tc, ag, arg_info);
@@ -3231,6 +3233,242 @@ static void try_eliminate_box_unbox_pair(MVMThreadContext *tc, MVMSpeshGraph *g,
 }
 
 
+/* A box and its matching unbox may also meet at a PHI: a native that is boxed
+ * before a loop and boxed again on each iteration, then unboxed at the top of
+ * the loop body, is never seen by the straight-line analysis above. If every
+ * value flowing into the PHI, perhaps through further PHIs, comes from a box
+ * of the matching kind, we give each of those boxes and PHIs a native shadow:
+ * a `set` into a register just after each box, and a mirrored PHI over
+ * those. All the object values in such a web are versions of one register, so
+ * they are never live at the same time, and neither are the shadow versions
+ * that mirror them, provided each web gets a native register of its own. Any
+ * `set` between the PHI and the unbox is mirrored too, into a register only it
+ * writes, as the copy may outlive the PHI's value. The unbox can then read the
+ * native copy, and the boxes are kept only if the object escapes elsewhere. */
+#define MAX_BOX_PHI_WEB 32
+typedef struct {
+    MVMSpeshIns *writer;
+    MVMSpeshOperand native;
+} NativeShadow;
+typedef struct {
+    /* Shadows created so far for boxes, PHIs and sets. */
+    MVM_VECTOR_DECL(NativeShadow, shadows);
+} BoxPhiState;
+static NativeShadow * find_native_shadow(BoxPhiState *bps, MVMSpeshIns *writer) {
+    MVMuint32 i;
+    for (i = 0; i < MVM_VECTOR_ELEMS(bps->shadows); i++)
+        if (bps->shadows[i].writer == writer)
+            return &(bps->shadows[i]);
+    return NULL;
+}
+static void add_native_shadow(BoxPhiState *bps, MVMSpeshIns *writer, MVMSpeshOperand native) {
+    NativeShadow ns;
+    ns.writer = writer;
+    ns.native = native;
+    MVM_VECTOR_PUSH(bps->shadows, ns);
+}
+static MVMuint32 collect_box_phi_web(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshIns *phi,
+                                     MVMuint16 box_op, MVMSpeshIns **web, MVMuint32 *web_size) {
+    MVMuint32 i, j, k;
+    web[0] = phi;
+    *web_size = 1;
+    for (i = 0; i < *web_size; i++) {
+        MVMSpeshIns *cur = web[i];
+        if (cur->info->opcode != MVM_SSA_PHI)
+            continue;
+        for (j = 1; j < cur->info->num_operands; j++) {
+            MVMSpeshIns *writer = MVM_spesh_get_facts(tc, g, cur->operands[j])->writer;
+            MVMuint32 seen = 0;
+            if (!writer || (writer->info->opcode != MVM_SSA_PHI && writer->info->opcode != box_op))
+                return 0;
+            for (k = 0; k < *web_size; k++) {
+                if (web[k] == writer) {
+                    seen = 1;
+                    break;
+                }
+            }
+            if (!seen) {
+                if (*web_size == MAX_BOX_PHI_WEB)
+                    return 0;
+                web[(*web_size)++] = writer;
+            }
+        }
+    }
+    return 1;
+}
+static MVMSpeshOperand native_shadow(MVMThreadContext *tc, MVMSpeshGraph *g, BoxPhiState *bps,
+                                     MVMSpeshIns *writer, MVMuint16 native_orig) {
+    MVMSpeshBB *bb = find_bb_with_instruction_linearly_after(tc, g, g->entry, writer);
+    NativeShadow *existing = find_native_shadow(bps, writer);
+    MVMSpeshOperand native;
+    MVMSpeshIns *shadow;
+    MVMuint32 i;
+
+    /* Re-use any existing shadow. */
+    if (existing)
+        return existing->native;
+
+    /* Make a new version of the native register, and record it before we go
+     * looking at PHI inputs, since they may lead back to this very PHI. */
+    native = MVM_spesh_manipulate_new_version(tc, g, native_orig);
+    add_native_shadow(bps, writer, native);
+    shadow = MVM_spesh_alloc(tc, g, sizeof(MVMSpeshIns));
+    if (writer->info->opcode == MVM_SSA_PHI) {
+        MVMuint16 num_operands = writer->info->num_operands;
+        shadow->info = get_phi(tc, g, num_operands);
+        shadow->operands = MVM_spesh_alloc(tc, g, num_operands * sizeof(MVMSpeshOperand));
+        shadow->operands[0] = native;
+        MVM_spesh_get_facts(tc, g, native)->writer = shadow;
+        MVM_spesh_manipulate_insert_ins(tc, bb, NULL, shadow);
+        for (i = 1; i < num_operands; i++) {
+            MVMSpeshIns *input = MVM_spesh_get_facts(tc, g, writer->operands[i])->writer;
+            shadow->operands[i] = native_shadow(tc, g, bps, input, native_orig);
+            MVM_spesh_usages_add_by_reg(tc, g, shadow->operands[i], shadow);
+        }
+    }
+    else {
+        shadow->info = MVM_op_get_op(MVM_OP_set);
+        shadow->operands = MVM_spesh_alloc(tc, g, 2 * sizeof(MVMSpeshOperand));
+        shadow->operands[0] = native;
+        shadow->operands[1] = writer->operands[1];
+        MVM_spesh_get_facts(tc, g, native)->writer = shadow;
+        MVM_spesh_usages_add_by_reg(tc, g, shadow->operands[1], shadow);
+        copy_facts(tc, g, native, shadow->operands[1]);
+        MVM_spesh_manipulate_insert_ins(tc, bb, writer, shadow);
+    }
+    return native;
+}
+static void try_eliminate_unbox_of_phi(MVMThreadContext *tc, MVMSpeshGraph *g, BoxPhiState *bps,
+                                       MVMSpeshIns *unbox_ins, MVMuint16 box_op, MVMuint16 kind) {
+    MVMSpeshIns *web[MAX_BOX_PHI_WEB];
+    MVMSpeshIns *chain[MAX_BOX_PHI_WEB];
+    MVMuint32 web_size, chain_size = 0, i;
+    MVMuint16 native_orig = 0;
+    MVMSpeshOperand native;
+
+    /* Look through any set chain to find the PHI. */
+    MVMSpeshIns *phi = MVM_spesh_get_facts(tc, g, unbox_ins->operands[1])->writer;
+    while (phi && phi->info->opcode == MVM_OP_set) {
+        if (chain_size == MAX_BOX_PHI_WEB)
+            return;
+        chain[chain_size++] = phi;
+        phi = MVM_spesh_get_facts(tc, g, phi->operands[1])->writer;
+    }
+    if (!phi || phi->info->opcode != MVM_SSA_PHI)
+        return;
+    if (!collect_box_phi_web(tc, g, phi, box_op, web, &web_size))
+        return;
+
+    /* A web that overlaps one shadowed before must use its native register,
+     * so the mirrored PHIs only merge versions of one register; otherwise the
+     * web gets a fresh one. */
+    for (i = 0; i < web_size; i++) {
+        NativeShadow *existing = find_native_shadow(bps, web[i]);
+        if (existing) {
+            if (native_orig && existing->native.reg.orig != native_orig)
+                return;
+            native_orig = existing->native.reg.orig;
+        }
+    }
+    if (!native_orig)
+        native_orig = MVM_spesh_manipulate_get_unique_reg(tc, g, kind);
+    else if (g->local_types[native_orig] != kind)
+        return;
+
+    /* Shadow the web, then each set on the way to the unbox. */
+    native = native_shadow(tc, g, bps, phi, native_orig);
+    while (chain_size--) {
+        MVMSpeshIns *set_ins = chain[chain_size];
+        NativeShadow *existing = find_native_shadow(bps, set_ins);
+        if (existing) {
+            native = existing->native;
+        }
+        else {
+            MVMSpeshBB *bb = find_bb_with_instruction_linearly_after(tc, g, g->entry, set_ins);
+            MVMSpeshIns *shadow = MVM_spesh_alloc(tc, g, sizeof(MVMSpeshIns));
+            shadow->info = MVM_op_get_op(MVM_OP_set);
+            shadow->operands = MVM_spesh_alloc(tc, g, 2 * sizeof(MVMSpeshOperand));
+            shadow->operands[0] = MVM_spesh_manipulate_new_version(tc, g,
+                MVM_spesh_manipulate_get_unique_reg(tc, g, kind));
+            shadow->operands[1] = native;
+            MVM_spesh_get_facts(tc, g, shadow->operands[0])->writer = shadow;
+            MVM_spesh_usages_add_by_reg(tc, g, shadow->operands[1], shadow);
+            copy_facts(tc, g, shadow->operands[0], shadow->operands[1]);
+            MVM_spesh_manipulate_insert_ins(tc, bb, set_ins, shadow);
+            native = shadow->operands[0];
+            add_native_shadow(bps, set_ins, native);
+        }
+    }
+
+    /* Rewrite the unbox into a set from the native copy. */
+    MVM_spesh_usages_delete_by_reg(tc, g, unbox_ins->operands[1], unbox_ins);
+    unbox_ins->info = MVM_op_get_op(MVM_OP_set);
+    unbox_ins->operands[1] = native;
+    MVM_spesh_usages_add_by_reg(tc, g, unbox_ins->operands[1], unbox_ins);
+    MVM_spesh_graph_add_comment(tc, g, unbox_ins, "unbox of PHI replaced by native PHI");
+
+    /* If the object PHIs are now only used by each other, delete them, so
+     * that the boxes feeding them may go away too. */
+    for (i = 0; i < web_size; i++) {
+        MVMSpeshFacts *facts;
+        MVMSpeshUseChainEntry *user_entry;
+        if (web[i]->info->opcode != MVM_SSA_PHI)
+            continue;
+        facts = MVM_spesh_get_facts(tc, g, web[i]->operands[0]);
+        if (facts->usage.deopt_users || facts->usage.handler_required)
+            return;
+        for (user_entry = facts->usage.users; user_entry; user_entry = user_entry->next) {
+            MVMuint32 j, in_web = 0;
+            for (j = 0; j < web_size; j++) {
+                if (web[j] == user_entry->user) {
+                    in_web = 1;
+                    break;
+                }
+            }
+            if (!in_web)
+                return;
+        }
+    }
+    for (i = 0; i < web_size; i++) {
+        if (web[i]->info->opcode == MVM_SSA_PHI) {
+            MVMSpeshBB *bb = find_bb_with_instruction_linearly_after(tc, g, g->entry, web[i]);
+            MVM_spesh_get_facts(tc, g, web[i]->operands[0])->dead_writer = 1;
+            MVM_spesh_manipulate_delete_ins(tc, g, bb, web[i]);
+        }
+    }
+}
+static void eliminate_box_unbox_through_phis(MVMThreadContext *tc, MVMSpeshGraph *g) {
+    BoxPhiState bps;
+    MVMSpeshBB *bb = g->entry;
+    MVM_VECTOR_INIT(bps.shadows, 0);
+    while (bb) {
+        MVMSpeshIns *ins = bb->first_ins;
+        while (ins) {
+            switch (ins->info->opcode) {
+                case MVM_OP_unbox_i:
+                case MVM_OP_decont_i:
+                    try_eliminate_unbox_of_phi(tc, g, &bps, ins, MVM_OP_box_i, MVM_reg_int64);
+                    break;
+                case MVM_OP_unbox_n:
+                case MVM_OP_decont_n:
+                    try_eliminate_unbox_of_phi(tc, g, &bps, ins, MVM_OP_box_n, MVM_reg_num64);
+                    break;
+                case MVM_OP_unbox_s:
+                case MVM_OP_decont_s:
+                    try_eliminate_unbox_of_phi(tc, g, &bps, ins, MVM_OP_box_s, MVM_reg_str);
+                    break;
+                case MVM_OP_unbox_u:
+                case MVM_OP_decont_u:
+                    try_eliminate_unbox_of_phi(tc, g, &bps, ins, MVM_OP_box_u, MVM_reg_uint64);
+                    break;
+            }
+            ins = ins->next;
+        }
+        bb = bb->linear_next;
+    }
+    MVM_VECTOR_DESTROY(bps.shadows);
+}
+
 static void post_inline_visit_bb(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
                                  PostInlinePassState *pips) {
     MVMint32 i;
@@ -3310,6 +3548,7 @@ static void post_inline_pass(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB
     /* Walk the basic blocks for the second pass. */
     PostInlinePassState pips;
     MVM_VECTOR_INIT(pips.seen_box_ins, 0);
+    eliminate_box_unbox_through_phis(tc, g);
     post_inline_visit_bb(tc, g, g->entry, &pips);
 
     /* Walk through any processed box instructions. */
@@ -3419,6 +3658,96 @@ static void merge_bbs(MVMThreadContext *tc, MVMSpeshGraph *g) {
     }
 }
 
+/* Checks if a frame declares any lexicals that code it calls may look for in
+ * its callers: those named like dynamic variables (that is, with a * twigil),
+ * and $/, $_ and $!, which are reached through getlexcaller, getlexdyn and
+ * CALLER:: lookups. */
+static MVMuint32 declares_dynamics(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    MVMuint32 i;
+    for (i = 0; i < sf->body.num_lexicals; i++) {
+        MVMString     *name   = sf->body.lexical_names_list[i];
+        MVMStringIndex graphs = MVM_string_graphs_nocheck(tc, name);
+        if (graphs > 1) {
+            MVMGrapheme32 twigil = MVM_string_get_grapheme_at_nocheck(tc, name, 1);
+            if (twigil == '*')
+                return 1;
+            if (graphs == 2 && MVM_string_get_grapheme_at_nocheck(tc, name, 0) == '$' &&
+                    (twigil == '/' || twigil == '_' || twigil == '!'))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/* Looks for invocations in tail position - that is, where the result is just
+ * returned - and turns them into tail calls, which at runtime replace the
+ * current frame with the callee's. We leave alone any covered by a handler,
+ * since it must stay in effect, and we don't do this at all in frames that
+ * the callee may be looking at. */
+static void tail_calls(MVMThreadContext *tc, MVMSpeshGraph *g) {
+    MVMSpeshBB *bb = g->entry;
+    MVMuint8   *active_handlers;
+    MVMuint32   num_active_handlers = 0;
+    if (!tc->instance->spesh_tailcall_enabled || g->sf->body.has_exit_handler ||
+            declares_dynamics(tc, g->sf))
+        return;
+    active_handlers = MVM_calloc(g->num_handlers + 1, 1);
+    while (bb) {
+        MVMSpeshIns *ins = bb->first_ins;
+        while (ins) {
+            /* Track the handlers covering the instruction, as in the CFG
+             * builder: process any starts before any ends. */
+            MVMSpeshAnn *ann = ins->annotations;
+            while (ann) {
+                if (ann->type == MVM_SPESH_ANN_FH_START &&
+                        !active_handlers[ann->data.frame_handler_index]) {
+                    active_handlers[ann->data.frame_handler_index] = 1;
+                    num_active_handlers++;
+                }
+                ann = ann->next;
+            }
+            ann = ins->annotations;
+            while (ann) {
+                if (ann->type == MVM_SPESH_ANN_FH_END &&
+                        active_handlers[ann->data.frame_handler_index]) {
+                    active_handlers[ann->data.frame_handler_index] = 0;
+                    num_active_handlers--;
+                }
+                ann = ann->next;
+            }
+
+            /* An invoke_o whose result is returned by the very next thing
+             * we do is in tail position. A handler starting or ending on the
+             * return still covers the invoke, since the return address is
+             * what is checked against its range. */
+            if (ins->info->opcode == MVM_OP_invoke_o && !num_active_handlers) {
+                MVMSpeshIns *ret_ins = ins->next;
+                if (!ret_ins && bb->num_succ == 1 && bb->succ[0] == bb->linear_next)
+                    ret_ins = bb->linear_next->first_ins;
+                if (ret_ins && ret_ins->info->opcode == MVM_OP_return_o &&
+                        ret_ins->operands[0].reg.orig == ins->operands[0].reg.orig &&
+                        ret_ins->operands[0].reg.i == ins->operands[0].reg.i) {
+                    MVMuint32 at_boundary = 0;
+                    ann = ret_ins->annotations;
+                    while (ann) {
+                        if (ann->type == MVM_SPESH_ANN_FH_START || ann->type == MVM_SPESH_ANN_FH_END)
+                            at_boundary = 1;
+                        ann = ann->next;
+                    }
+                    if (!at_boundary) {
+                        ins->info = MVM_op_get_op(MVM_OP_sp_tailinvoke_o);
+                        MVM_spesh_graph_add_comment(tc, g, ins, "tail call");
+                    }
+                }
+            }
+
+            ins = ins->next;
+        }
+        bb = bb->linear_next;
+    }
+    MVM_free(active_handlers);
+}
+
 /* Drives the overall optimization work taking place on a spesh graph. */
 void MVM_spesh_optimize(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshPlanned *p) {
     /* Before starting, we eliminate dead basic blocks that were tossed by
@@ -3458,6 +3787,9 @@ void MVM_spesh_optimize(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshPlanned
     MVM_spesh_eliminate_dead_ins(tc, g);
     MVM_spesh_eliminate_dead_bbs(tc, g, 1);
 
+    /* Now the final shape of the code is known, find any tail calls. */
+    tail_calls(tc, g);
+
 #if MVM_SPESH_CHECK_DU
     MVM_spesh_usages_check(tc, g);
 #endif
@@ -24,6 +24,7 @@ void perform_osr(MVMThreadContext *tc, MVMSpeshCandidate *specialized) {
     MVMint32 num_locals;
     /* Work out the OSR deopt index, to locate the entry point. */
     MVMint32 osr_index = get_osr_deopt_index(tc, specialized);
+    specialized->usage_count++;
 #if MVM_LOG_OSR
     fprintf(stderr, "Performing OSR of frame '%s' (cuid: %s) at index %d\n",
         MVM_string_utf8_encode_C_string(tc, tc->cur_frame->static_info->body.name),
@@ -167,8 +168,15 @@ void MVM_spesh_osr_poll_for_result(MVMThreadContext *tc) {
                 spesh->body.spesh_arg_guard,
                 (cs && cs->is_interned ? cs : NULL),
                 args, NULL);
-            if (ag_result >= 0)
-                perform_osr(tc, spesh->body.spesh_candidates[ag_result]);
+            if (ag_result >= 0) {
+                /* A loop region candidate can only be entered at the head
+                 * of its loop, so if we're not there, keep looking. */
+                MVMSpeshCandidate *cand = spesh->body.spesh_candidates[ag_result];
+                if (cand->is_region && cand->region_osr_offset + 2 !=
+                        *(tc->interp_cur_op) - *(tc->interp_bytecode_start))
+                    return;
+                perform_osr(tc, cand);
+            }
         }
 
         /* Update state for avoiding checks in the common case. */
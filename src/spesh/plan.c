@@ -6,6 +6,9 @@ MVMint32 have_existing_specialization(MVMThreadContext *tc, MVMStaticFrame *sf,
     MVMStaticFrameSpesh *sfs = sf->body.spesh;
     MVMuint32 i;
     for (i = 0; i < sfs->body.num_spesh_candidates; i++) {
+        /* Discarded candidates don't count; we want to replace them. */
+        if (sfs->body.spesh_candidates[i]->discarded)
+            continue;
         if (sfs->body.spesh_candidates[i]->cs == cs) {
             /* Callsite matches. Is it a matching certain specialization? */
             MVMSpeshStatsType *cand_type_tuple = sfs->body.spesh_candidates[i]->type_tuple;
@@ -32,7 +35,10 @@ void add_planned(MVMThreadContext *tc, MVMSpeshPlan *plan, MVMSpeshPlannedKind k
                  MVMSpeshStatsType *type_tuple, MVMSpeshStatsByType **type_stats,
                  MVMuint32 num_type_stats) {
     MVMSpeshPlanned *p;
-    if (sf->body.bytecode_size > MVM_SPESH_MAX_BYTECODE_SIZE ||
+    MVMSpeshStats *ss = sf->body.spesh->body.spesh_stats;
+    MVMuint8 is_region = sf->body.bytecode_size > MVM_SPESH_MAX_BYTECODE_SIZE;
+    if (sf->body.bytecode_size > MVM_SPESH_MAX_REGION_BYTECODE_SIZE ||
+        (is_region && (cs_stats->osr_hits < MVM_SPESH_PLAN_CS_MIN_OSR || !ss->hot_osr_votes)) ||
         have_existing_specialization(tc, sf, cs_stats->cs, type_tuple)) {
         /* Clean up allocated memory.
          * NB - the only caller is plan_for_cs, which means that we could do the
@@ -54,6 +60,8 @@ void add_planned(MVMThreadContext *tc, MVMSpeshPlan *plan, MVMSpeshPlannedKind k
     p->type_tuple = type_tuple;
     p->type_stats = type_stats;
     p->num_type_stats = num_type_stats;
+    p->is_region = is_region;
+    p->region_osr_offset = is_region ? ss->hot_osr_offset : 0;
     if (num_type_stats) {
         MVMuint32 i;
         p->max_depth = type_stats[0]->max_depth;
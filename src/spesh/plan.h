@@ -69,6 +69,11 @@ struct MVMSpeshPlanned {
     /* Number of entries in the type_stats array. (For an observed type
      * specialization, this would be 1.) */
     MVMuint32 num_type_stats;
+
+    /* Set if the frame is too large to specialize as a whole, and we should
+     * specialize only the loop headed by the OSR point at region_osr_offset. */
+    MVMuint8 is_region;
+    MVMuint32 region_osr_offset;
 };
 
 MVMSpeshPlan * MVM_spesh_plan(MVMThreadContext *tc, MVMObject *updated_static_frames, MVMuint64 *certain_specialization, MVMuint64 *observed_specialization, MVMuint64 *osr_specialization);
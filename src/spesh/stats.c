@@ -620,8 +620,16 @@ void MVM_spesh_stats_update(MVMThreadContext *tc, MVMSpeshLog *sl, MVMObject *sf
             }
             case MVM_SPESH_LOG_OSR: {
                 MVMSpeshSimStackFrame *simf = sim_stack_find(tc, sims, e->id, sf_updated);
-                if (simf)
+                if (simf) {
+                    MVMSpeshStats *ss = simf->ss;
                     simf->osr_hits++;
+                    if (ss->hot_osr_votes == 0)
+                        ss->hot_osr_offset = e->osr.bytecode_offset;
+                    if (ss->hot_osr_offset == e->osr.bytecode_offset)
+                        ss->hot_osr_votes++;
+                    else
+                        ss->hot_osr_votes--;
+                }
                 break;
             }
             case MVM_SPESH_LOG_STATIC: {
@@ -636,6 +644,26 @@ void MVM_spesh_stats_update(MVMThreadContext *tc, MVMSpeshLog *sl, MVMObject *sf
                     sim_stack_pop(tc, sims, sf_updated);
                 break;
             }
+            case MVM_SPESH_LOG_DEOPT_STORM: {
+                /* Discard the candidate. If we still have stats, then plan
+                 * for the frame again right away; otherwise, let it record
+                 * some more. */
+                MVMStaticFrame *sf = e->deopt.sf;
+                if (MVM_spesh_deopt_storm(tc, sf, e->deopt.cand, e->deopt.guard_sf,
+                        e->deopt.deopt_target)) {
+                    MVMSpeshStats *ss = sf->body.spesh->body.spesh_stats;
+                    if (ss) {
+                        if (ss->last_update != tc->instance->spesh_stats_version) {
+                            ss->last_update = tc->instance->spesh_stats_version;
+                            MVM_repr_push_o(tc, sf_updated, (MVMObject *)sf);
+                        }
+                    }
+                    else {
+                        sf->body.spesh->body.spesh_entries_recorded = 0;
+                    }
+                }
+                break;
+            }
         }
     }
     save_or_free_sim_stack(tc, sims, log_from_tc, sf_updated);
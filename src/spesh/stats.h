@@ -21,6 +21,12 @@ struct MVMSpeshStats {
     /* Total OSR hits across all callsites. */
     MVMuint32 osr_hits;
 
+    /* The bytecode offset of the OSR point hit the most, as found by a
+     * majority vote over the OSR hits, along with its remaining votes. Used
+     * to pick the loop to optimize in a frame too big to optimize whole. */
+    MVMuint32 hot_osr_offset;
+    MVMuint32 hot_osr_votes;
+
     /* The latest version of the statistics when this was updated. Used to
      * help decide when to throw out data that is no longer evolving, to
      * reduce memory use. */
@@ -1,4 +1,9 @@
 /* The maximum size of bytecode we'll ever attempt to optimize. */
 #define MVM_SPESH_MAX_BYTECODE_SIZE 65536
 
+/* Frames bigger than that, up to this size, are too big to be optimized as a
+ * whole, but we may still optimize their hottest loop as a region, entering
+ * it by OSR and deoptimizing at its exits. */
+#define MVM_SPESH_MAX_REGION_BYTECODE_SIZE (16 * 65536)
+
 MVMuint32 MVM_spesh_threshold(MVMThreadContext *tc, MVMStaticFrame *sf);
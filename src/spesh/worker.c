@@ -156,6 +156,9 @@ static void worker(MVMThreadContext *tc, MVMCallsite *callsite, MVMRegister *arg
                     MVM_spesh_plan_destroy(tc, tc->instance->spesh_plan);
                     tc->instance->spesh_plan = NULL;
 
+                    /* Evict cold specializations if we are over budget. */
+                    MVM_spesh_candidate_evict(tc);
+
                     if (overview_data) {
                         overview_data[12] = (uv_hrtime() - start_time) / 1000;
                     }
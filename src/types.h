@@ -14,6 +14,9 @@ typedef struct MVMBoolificationSpec MVMBoolificationSpec;
 typedef struct MVMBootTypes MVMBootTypes;
 typedef struct MVMEventSubscriptions MVMEventSubscriptions;
 typedef struct MVMBytecodeAnnotation MVMBytecodeAnnotation;
+typedef struct MVMBytecodeWriter MVMBytecodeWriter;
+typedef struct MVMBytecodeWriterBody MVMBytecodeWriterBody;
+typedef struct MVMBytecodeWriterBuffer MVMBytecodeWriterBuffer;
 typedef struct MVMCallCapture MVMCallCapture;
 typedef struct MVMCallCaptureBody MVMCallCaptureBody;
 typedef struct MVMCallsite MVMCallsite;
@@ -65,6 +68,8 @@ typedef struct MVMHashBody MVMHashBody;
 typedef struct MVMHashEntry MVMHashEntry;
 typedef struct MVMHLLConfig MVMHLLConfig;
 typedef struct MVMIntConstCache MVMIntConstCache;
+typedef struct MVMInlineCache MVMInlineCache;
+typedef struct MVMInlineCacheEntry MVMInlineCacheEntry;
 typedef struct MVMInstance MVMInstance;
 typedef struct MVMInvocationSpec MVMInvocationSpec;
 typedef struct MVMIter MVMIter;
@@ -144,6 +149,8 @@ typedef struct MVMP6opaqueNameMap MVMP6opaqueNameMap;
 typedef struct MVMP6opaqueREPRData MVMP6opaqueREPRData;
 typedef struct MVMP6str MVMP6str;
 typedef struct MVMP6strBody MVMP6strBody;
+typedef union  MVMPredecodedCell MVMPredecodedCell;
+typedef struct MVMPredecoded MVMPredecoded;
 typedef union  MVMRegister MVMRegister;
 typedef struct MVMREPROps MVMREPROps;
 typedef struct MVMREPROps_Associative MVMREPROps_Associative;
@@ -224,6 +231,9 @@ typedef struct MVMThreadBody MVMThreadBody;
 typedef struct MVMThreadContext MVMThreadContext;
 typedef struct MVMUnicodeNamedValue MVMUnicodeNamedValue;
 typedef struct MVMUninstantiable MVMUninstantiable;
+typedef struct MVMValidationCache MVMValidationCache;
+typedef struct MVMValidationFused MVMValidationFused;
+typedef struct MVMValidationRecord MVMValidationRecord;
 typedef struct MVMWorkThread MVMWorkThread;
 typedef struct MVMIOOps MVMIOOps;
 typedef struct MVMIOClosable MVMIOClosable;
@@ -246,6 +256,7 @@ typedef struct MVMJitGraph MVMJitGraph;
 typedef struct MVMJitNode MVMJitNode;
 typedef struct MVMJitDeopt MVMJitDeopt;
 typedef struct MVMJitInline MVMJitInline;
+typedef struct MVMJitLineNumber MVMJitLineNumber;
 typedef struct MVMJitHandler MVMJitHandler;
 typedef struct MVMJitPrimitive MVMJitPrimitive;
 typedef struct MVMJitBranch MVMJitBranch;
@@ -151,6 +151,7 @@ delete @ENV{qw(
     MVM_JIT_EXPR_LAST_FRAME
     MVM_JTI_EXPR_LAST_BB
     MVM_JIT_DISABLE
+    MVM_JIT_PEEPHOLE_DISABLE
     MVM_SPESH_LIMIT
     MVM_SPESH_DISABLE
 )};
@@ -223,6 +224,17 @@ if ($OPTS{spesh}) {
     }, $timeout);
     printf STDERR ('JIT Broken Frame/BB: %d / %d'."\n", $last_good_frame + 1, $last_good_block + 1);
 
+    # check if the breakage is due to the peephole pass over the tiles
+    my $peephole_status = quietly {
+        run_with(\@command, {
+            MVM_JIT_EXPR_LAST_FRAME => $last_good_frame + 1,
+            MVM_JIT_EXPR_LAST_BB => $last_good_block + 1,
+            MVM_JIT_PEEPHOLE_DISABLE => 1,
+        }, $timeout);
+    };
+    printf STDERR ("JIT peephole optimizer: %s\n", $peephole_status == 0 ?
+                   'NOT OK (program passes with MVM_JIT_PEEPHOLE_DISABLE)' : 'OK');
+
     run_with(\@command, {
         MVM_SPESH_LOG => sprintf('spesh-%04d-%04d.txt',
                                  $last_good_frame + 1, $last_good_block + 1),